@@ -29,105 +29,65 @@
 #include "menu.h"
 #include "snes9xtx.h"
 #include "snes9x/memmap.h"
+#include "snes9x/filterpipe.h"
 
-#define	Mask_2	0x07E0	// 00000 111111 00000
-#define	Mask13	0xF81F	// 11111 000000 11111
+// Each filter is a chain of filterpipe.cpp stages
+struct FilterPreset
+{
+	const char *name;
+	int count;
+	uint8 stages[FILTER_MAX_STAGES];
+};
+
+static const FilterPreset presets[NUM_FILTERS] =
+{
+	{ "None",                0, { } },
+	{ "TV Mode",             1, { FILTER_STAGE_TVMODE } },
+	{ "Scale2x",             1, { FILTER_STAGE_SCALE2X } },
+	{ "CRT",                 2, { FILTER_STAGE_CRT2X, FILTER_STAGE_COLOUR } },
+	{ "Scale2x + Scanlines", 2, { FILTER_STAGE_SCALE2X, FILTER_STAGE_SCANLINES } }
+};
 
 TFilterMethod FilterMethod;
 
-template<int GuiScale> void RenderTVMode (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
-template<int GuiScale> void RenderScale2X (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
+static struct SFilterPipeline pipeline;
 
-const char* GetFilterName (RenderFilter filterID)
+static void RenderPipeline (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
 {
-	switch(filterID)
-	{
-		default: return "Unknown";
-		case FILTER_NONE: return "None";
-		case FILTER_TVMODE: return "TV Mode";
-		case FILTER_SCALE2X: return "Scale2x";
-	}
+	S9xFilterPipelineRun(&pipeline, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
-// Return pointer to appropriate function
-static TFilterMethod FilterToMethod (RenderFilter filterID)
+const char* GetFilterName (RenderFilter filterID)
 {
-	switch(filterID)
-	{
-		case FILTER_TVMODE:   return RenderTVMode<FILTER_TVMODE>;
-		case FILTER_SCALE2X:  return RenderScale2X<FILTER_SCALE2X>;
-		default: return 0;
-	}
+	if (filterID < 0 || filterID >= NUM_FILTERS)
+		return "Unknown";
+
+	return presets[filterID].name;
 }
 
 int GetFilterScale(RenderFilter filterID)
 {
-	switch(filterID)
-	{
-		case FILTER_NONE:
-			return 1;
-		default:
-		case FILTER_TVMODE:
-		case FILTER_SCALE2X:
-			return 2;
-	}
+	int scale = 1;
+
+	if (filterID < 0 || filterID >= NUM_FILTERS)
+		return 2;
+
+	for (int s = 0; s < presets[filterID].count; s++)
+		scale *= FilterStages[presets[filterID].stages[s]].Scale;
+
+	return scale;
 }
 
 void SelectFilterMethod ()
 {
-	FilterMethod = FilterToMethod((RenderFilter)GCSettings.VideoFilter);
-}
+	RenderFilter filterID = (RenderFilter)GCSettings.VideoFilter;
 
-template<int GuiScale>
-void RenderTVMode (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
-{
-	unsigned int nextlineSrc = srcPitch / sizeof(uint16);
-	uint16 *p = (uint16 *)srcPtr;
-
-	unsigned int nextlineDst = dstPitch / sizeof(uint16);
-	uint16 *q = (uint16 *)dstPtr;
-
-	while(height--) {
-		for (int i = 0, j = 0; i < width; ++i, j += 2) {
-			uint16 p1 = *(p + i);
-			uint32 pi;
-
-			pi = (((p1 & Mask_2) * 6) >> 3) & Mask_2;
-			pi |= (((p1 & Mask13) * 6) >> 3) & Mask13;
-
-			*(q + j) = p1;
-			*(q + j + 1) = p1;
-			*(q + j + nextlineDst) = (uint16)pi;
-			*(q + j + nextlineDst + 1) = (uint16)pi;
-		}
-		p += nextlineSrc;
-		q += nextlineDst << 1;
-	}
-}
+	S9xFilterPipelineDeinit(&pipeline);
+	FilterMethod = 0;
 
-template<int GuiScale>
-void RenderScale2X (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
-{
-	unsigned int nextlineSrc = srcPitch / sizeof(uint16);
-	uint16 *p = (uint16 *)srcPtr;
-
-	unsigned int nextlineDst = dstPitch / sizeof(uint16);
-	uint16 *q = (uint16 *)dstPtr;
-
-	while (height--) {
-		for (int i = 0; i < width; ++i) {
-			uint16 B = *(p + i - nextlineSrc);
-			uint16 D = *(p + i - 1);
-			uint16 E = *(p + i);
-			uint16 F = *(p + i + 1);
-			uint16 H = *(p + i + nextlineSrc);
-
-			*(q + (i << 1)) = D == B && B != F && D != H ? D : E;
-			*(q + (i << 1) + 1) = B == F && B != D && F != H ? F : E;
-			*(q + (i << 1) + nextlineDst) = D == H && D != B && H != F ? D : E;
-			*(q + (i << 1) + nextlineDst + 1) = H == F && D != H && B != F ? F : E;
-		}
-		p += nextlineSrc;
-		q += nextlineDst << 1;
-	}
+	if (filterID <= FILTER_NONE || filterID >= NUM_FILTERS)
+		return;
+
+	if (S9xFilterPipelineInit(&pipeline, presets[filterID].stages, presets[filterID].count))
+		FilterMethod = RenderPipeline;
 }
@@ -27,6 +27,8 @@ enum RenderFilter{
 
 	FILTER_TVMODE,
 	FILTER_SCALE2X,
+	FILTER_CRT,
+	FILTER_SCALE2X_SCANLINES,
 
 	NUM_FILTERS
 };
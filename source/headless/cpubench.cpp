@@ -0,0 +1,162 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * cpubench.cpp
+ *
+ * 65c816 opcode throughput benchmark. Runs a fixed instruction mix from
+ * WRAM through the same fetch/dispatch sequence as S9xMainLoop, once per
+ * opcode table (E1, M1X1, M1X0, M0X1, M0X0), with H-events held off so
+ * only the opcode handlers and memory access paths are timed.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/memmap.h"
+#include "snes9x/cpuexec.h"
+
+#define BENCH_BANK	0x7e
+#define BENCH_PC	0x1000
+
+struct BenchMode
+{
+	const char *name;
+	bool emulation;
+	bool m8;
+	bool x8;
+};
+
+static const BenchMode benchModes[] =
+{
+	{ "E1",   true,  true,  true  },
+	{ "M1X1", false, true,  true  },
+	{ "M1X0", false, true,  false },
+	{ "M0X1", false, false, true  },
+	{ "M0X0", false, false, false }
+};
+
+/****************************************************************************
+ * AssembleLoop
+ *
+ * Loads, stores, ALU, read-modify-write, stack, transfer and branch opcodes
+ * over direct page, absolute, indexed and indirect addressing. Immediates
+ * are sized for the mode. X is reloaded every pass so indexed accesses stay
+ * inside WRAM. Returns the number of instructions in one pass.
+ ***************************************************************************/
+static int AssembleLoop(uint8 *code, bool m8, bool x8)
+{
+	int pc = 0, ops = 0;
+
+	#define B(v)	code[pc++] = (v)
+	#define W(v)	{ B((v) & 0xff); B((v) >> 8); }
+	#define IMM_M(v)	{ if (m8) B(v); else W(v); }
+	#define IMM_X(v)	{ if (x8) B(v); else W(v); }
+	#define OP(n)	ops += (n)
+
+	B(0xa2); IMM_X(0x00);			OP(1);	// ldx #0
+	B(0xa0); IMM_X(0x04);			OP(1);	// ldy #4
+	B(0xa5); B(0x10);				OP(1);	// lda $10
+	B(0x18);						OP(1);	// clc
+	B(0x69); IMM_M(0x11);			OP(1);	// adc #
+	B(0x95); B(0x20);				OP(1);	// sta $20,x
+	B(0x8d); W(0x0300);				OP(1);	// sta $0300
+	B(0xbd); W(0x0400);				OP(1);	// lda $0400,x
+	B(0x29); IMM_M(0x7f);			OP(1);	// and #
+	B(0x0d); W(0x0302);				OP(1);	// ora $0302
+	B(0x99); W(0x0500);				OP(1);	// sta $0500,y
+	B(0xb1); B(0x30);				OP(1);	// lda ($30),y
+	B(0x92); B(0x30);				OP(1);	// sta ($30)
+	B(0xe6); B(0x12);				OP(1);	// inc $12
+	B(0x4e); W(0x0304);				OP(1);	// lsr $0304
+	B(0x0a);						OP(1);	// asl
+	B(0xaa);						OP(1);	// tax
+	B(0xe8);						OP(1);	// inx
+	B(0xc8);						OP(1);	// iny
+	B(0x48);						OP(1);	// pha
+	B(0x68);						OP(1);	// pla
+	B(0xc9); IMM_M(0x55);			OP(1);	// cmp #
+	B(0xe0); IMM_X(0x40);			OP(1);	// cpx #
+	B(0xf0); B(0x00);				OP(1);	// beq +0
+	B(0x24); B(0x14);				OP(1);	// bit $14
+	B(0xa5); B(0x16);				OP(1);	// lda $16
+	B(0xe5); B(0x18);				OP(1);	// sbc $18
+	B(0x85); B(0x1a);				OP(1);	// sta $1a
+	int top = -(pc + 2);
+	B(0x80); B((uint8) top);		OP(1);	// bra to the top
+
+	#undef B
+	#undef W
+	#undef IMM_M
+	#undef IMM_X
+	#undef OP
+
+	return ops;
+}
+
+static void SetMode(const BenchMode &mode)
+{
+	Registers.PL = IRQ | (mode.m8 ? MemoryFlag : 0) | (mode.x8 ? IndexFlag : 0);
+	Registers.PH = mode.emulation ? 1 : 0;
+	Registers.D.W = 0;
+	Registers.DB = 0;
+	ICPU.ShiftedDB = 0;
+	Registers.S.W = mode.emulation ? 0x01ff : 0x1fff;
+	Registers.A.W = 0x1234;
+	S9xUnpackStatus();
+	S9xFixCycles();
+	S9xSetPCBase((BENCH_BANK << 16) | BENCH_PC);
+}
+
+/****************************************************************************
+ * HeadlessCPUBench
+ *
+ * Runs 'ops' instructions per opcode table and prints ns/opcode. Needs a
+ * loaded ROM (for the memory map); clobbers WRAM and CPU state.
+ ***************************************************************************/
+void HeadlessCPUBench(uint32 ops)
+{
+	int modes = sizeof(benchModes) / sizeof(benchModes[0]);
+	double total = 0;
+
+	printf("cpu benchmark: %u opcodes per table\n", ops);
+
+	for (int m = 0; m < modes; m++)
+	{
+		uint8 *code = Memory.RAM + BENCH_PC;
+		int mix = AssembleLoop(code, benchModes[m].emulation || benchModes[m].m8, benchModes[m].emulation || benchModes[m].x8);
+
+		// (dp) pointer for the indirect loads and stores
+		Memory.RAM[0x30] = 0x00;
+		Memory.RAM[0x31] = 0x06;
+
+		SetMode(benchModes[m]);
+
+		CPU.Flags = 0;
+		CPU.InDMAorHDMA = FALSE;
+		CPU.NextEvent = 0x7fffffff;
+		CPU.Cycles = 0;
+
+		uint64 start = HeadlessTimeNS();
+
+		for (uint32 i = 0; i < ops; i++)
+		{
+			uint8 Op = CPU.PCBase[Registers.PCw];
+			CPU.Cycles += CPU.MemSpeed;
+			Registers.PCw++;
+			(*ICPU.S9xOpcodes[Op].S9xOpcode)();
+
+			if (CPU.Cycles > 0x40000000)
+				CPU.Cycles = 0;
+		}
+
+		uint64 elapsed = HeadlessTimeNS() - start;
+		total += elapsed;
+
+		printf("  %-5s %7.2f ns/opcode  %7.1f Mops/s  (%d-opcode mix)\n", benchModes[m].name,
+			(double) elapsed / ops, ops * 1e3 / elapsed, mix);
+	}
+
+	printf("  all   %7.2f ns/opcode\n", total / ((double) ops * modes));
+}
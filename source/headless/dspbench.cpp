@@ -0,0 +1,142 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * dspbench.cpp
+ *
+ * S-DSP throughput benchmark. Runs a standalone SPC_DSP with all eight
+ * voices playing a looped BRR sample at different pitches, once per
+ * interpolation method, and reports output samples per second.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/apu/apu.h"
+#include "snes9x/apu/SPC_DSP.h"
+
+#define BENCH_DIR		0x0200
+#define BENCH_SAMPLE	0x0300
+#define BENCH_BLOCKS	64
+#define BENCH_CHUNK		2048	// stereo samples per run() call
+
+struct BenchMethod
+{
+	const char *name;
+	int method;
+};
+
+static const BenchMethod benchMethods[] =
+{
+	{ "none",     DSP_INTERPOLATION_NONE     },
+	{ "linear",   DSP_INTERPOLATION_LINEAR   },
+	{ "gaussian", DSP_INTERPOLATION_GAUSSIAN },
+	{ "cubic",    DSP_INTERPOLATION_CUBIC    },
+	{ "sinc",     DSP_INTERPOLATION_SINC     }
+};
+
+static SPC_DSP dsp;
+static uint8 ram[0x10000];
+static SPC_DSP::sample_t out[BENCH_CHUNK * 2];
+
+/****************************************************************************
+ * SetupVoices
+ *
+ * One looping BRR sample of pseudo-random blocks with mixed filters, echo
+ * off, every voice keyed on with direct gain and its own pitch.
+ ***************************************************************************/
+static void SetupVoices()
+{
+	uint32 seed = 7;
+
+	memset(ram, 0, sizeof(ram));
+
+	ram[BENCH_DIR + 0] = BENCH_SAMPLE & 0xff;
+	ram[BENCH_DIR + 1] = BENCH_SAMPLE >> 8;
+	ram[BENCH_DIR + 2] = BENCH_SAMPLE & 0xff;
+	ram[BENCH_DIR + 3] = BENCH_SAMPLE >> 8;
+
+	for (int b = 0; b < BENCH_BLOCKS; b++)
+	{
+		uint8 *block = ram + BENCH_SAMPLE + b * 9;
+
+		block[0] = 0xb0 | ((b & 3) << 2) | (b == BENCH_BLOCKS - 1 ? 3 : 0);
+		for (int i = 1; i < 9; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			block[i] = seed >> 16;
+		}
+	}
+
+	dsp.init(ram);
+	dsp.reset();
+
+	dsp.write(SPC_DSP::r_flg, 0x20);
+	dsp.write(SPC_DSP::r_dir, BENCH_DIR >> 8);
+	dsp.write(SPC_DSP::r_mvoll, 0x7f);
+	dsp.write(SPC_DSP::r_mvolr, 0x7f);
+	dsp.write(SPC_DSP::r_evoll, 0);
+	dsp.write(SPC_DSP::r_evolr, 0);
+	dsp.write(SPC_DSP::r_eon, 0);
+	dsp.write(SPC_DSP::r_non, 0);
+	dsp.write(SPC_DSP::r_pmon, 0);
+
+	for (int v = 0; v < SPC_DSP::voice_count; v++)
+	{
+		int pitch = 0x0800 + v * 0x0155;
+
+		dsp.write(v * 0x10 + SPC_DSP::v_voll, 0x30);
+		dsp.write(v * 0x10 + SPC_DSP::v_volr, 0x30);
+		dsp.write(v * 0x10 + SPC_DSP::v_pitchl, pitch & 0xff);
+		dsp.write(v * 0x10 + SPC_DSP::v_pitchh, pitch >> 8);
+		dsp.write(v * 0x10 + SPC_DSP::v_srcn, 0);
+		dsp.write(v * 0x10 + SPC_DSP::v_adsr0, 0);
+		dsp.write(v * 0x10 + SPC_DSP::v_gain, 0x7f);
+	}
+
+	dsp.write(SPC_DSP::r_koff, 0);
+	dsp.write(SPC_DSP::r_kon, 0xff);
+}
+
+/****************************************************************************
+ * HeadlessDSPBench
+ *
+ * Generates 'samples' stereo samples per interpolation method and prints
+ * samples/sec, plus how many times faster than real time (32 kHz) that is.
+ ***************************************************************************/
+void HeadlessDSPBench(uint32 samples)
+{
+	int methods = sizeof(benchMethods) / sizeof(benchMethods[0]);
+	int32 savedMethod = Settings.InterpolationMethod;
+
+	printf("dsp benchmark: %u samples per method\n", samples);
+
+	for (int m = 0; m < methods; m++)
+	{
+		Settings.InterpolationMethod = benchMethods[m].method;
+		SetupVoices();
+
+		uint32 done = 0;
+		uint32 crc = 0;
+		uint64 start = HeadlessTimeNS();
+
+		while (done < samples)
+		{
+			dsp.set_output(out, BENCH_CHUNK * 2);
+			dsp.run(BENCH_CHUNK * 32);
+			done += BENCH_CHUNK;
+		}
+
+		uint64 elapsed = HeadlessTimeNS() - start;
+
+		// checksum of the last chunk, to compare kernels between builds
+		for (int i = 0; i < BENCH_CHUNK * 2; i++)
+			crc = crc * 31 + (uint16) out[i];
+
+		printf("  %-8s %7.2f Msamples/s  %6.0fx real time  (last chunk %08x)\n", benchMethods[m].name,
+			done * 1e3 / elapsed, done * 1e9 / elapsed / 32000, crc);
+	}
+
+	Settings.InterpolationMethod = savedMethod;
+}
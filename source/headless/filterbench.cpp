@@ -0,0 +1,210 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * filterbench.cpp
+ *
+ * Video filter benchmark, and the -filter hook that runs a filter pipeline
+ * (filterpipe.h) on every displayed frame. The benchmark times each stage
+ * on a synthetic 256x224 frame, SIMD and scalar, next to its cost
+ * estimate.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/gfx.h"
+#include "snes9x/filterpipe.h"
+
+#define BENCH_WIDTH		256
+#define BENCH_HEIGHT	224
+
+static struct SFilterPipeline filterPipeline;
+static uint16 *filterOut = NULL;
+#ifdef FILTER_THREAD
+static bool filterThreaded = false;
+#endif
+
+/****************************************************************************
+ * FillFrame
+ *
+ * 8x8 blocks of two colours each in a pseudo-random pattern, with every
+ * fourth block flat, so there are both edges and flat areas to filter.
+ ***************************************************************************/
+static void FillFrame(uint16 *frame)
+{
+	uint32 seed = 11;
+
+	for (int by = 0; by < BENCH_HEIGHT; by += 8)
+	{
+		for (int bx = 0; bx < BENCH_WIDTH; bx += 8)
+		{
+			seed = seed * 1103515245 + 12345;
+			uint16 a = seed >> 16;
+			seed = seed * 1103515245 + 12345;
+			uint16 b = (bx & 0x18) == 0x18 ? a : seed >> 16;
+
+			for (int y = 0; y < 8; y++)
+			{
+				seed = seed * 1103515245 + 12345;
+				uint8 bits = seed >> 24;
+
+				for (int x = 0; x < 8; x++)
+					frame[(by + y) * BENCH_WIDTH + bx + x] = (bits >> x) & 1 ? a : b;
+			}
+		}
+	}
+}
+
+/****************************************************************************
+ * HeadlessFilterBench
+ *
+ * Runs every filter stage 'passes' times over the same frame, with the
+ * SIMD and the scalar kernel. The checksums of the two must match.
+ ***************************************************************************/
+void HeadlessFilterBench(uint32 passes)
+{
+	uint16 *frame = (uint16 *) malloc(BENCH_WIDTH * BENCH_HEIGHT * sizeof(uint16));
+	uint16 *out = (uint16 *) malloc(BENCH_WIDTH * 2 * BENCH_HEIGHT * 2 * sizeof(uint16));
+	uint32 pixels = BENCH_WIDTH * BENCH_HEIGHT;
+
+	printf("filter benchmark: %u passes over a %dx%d frame per stage\n", passes, BENCH_WIDTH, BENCH_HEIGHT);
+
+	FillFrame(frame);
+
+	for (int s = 0; s < NUM_FILTER_STAGES; s++)
+	{
+		const SFilterStage &stage = FilterStages[s];
+		struct SFilterPipeline fp;
+		uint8 id = s;
+		double ns[2];
+		uint32 crc[2];
+
+		// Builds the lookup tables the stage needs
+		if (!S9xFilterPipelineInit(&fp, &id, 1))
+			continue;
+		S9xFilterPipelineDeinit(&fp);
+
+		uint32 outPitch = BENCH_WIDTH * stage.Scale * sizeof(uint16);
+
+		for (int k = 0; k < 2; k++)
+		{
+			TFilterStageMethod run = k ? stage.RunScalar : stage.Run;
+			uint64 start = HeadlessTimeNS();
+
+			for (uint32 p = 0; p < passes; p++)
+				run((uint8 *) frame, BENCH_WIDTH * sizeof(uint16), (uint8 *) out, outPitch, BENCH_WIDTH, BENCH_HEIGHT);
+
+			ns[k] = (double) (HeadlessTimeNS() - start) / passes / pixels;
+			crc[k] = crc32(0, (uint8 *) out, outPitch * BENCH_HEIGHT * stage.Scale);
+		}
+
+		printf("  %-9s %6.2f ns/pixel  %6.2f scalar  (estimate %3u cycles)  (crc %08x%s)\n", stage.Name,
+			ns[0], ns[1], stage.Cost, crc[0], crc[0] == crc[1] ? "" : ", scalar differs");
+	}
+
+	free(frame);
+	free(out);
+}
+
+/****************************************************************************
+ * HeadlessFilterInit
+ *
+ * 'list' names the stages to chain, separated by commas, e.g.
+ * "scale2x,scanlines". With 'threaded', frames are filtered on a worker
+ * thread (FILTER_THREAD builds).
+ ***************************************************************************/
+bool HeadlessFilterInit(const char *list, bool threaded)
+{
+	uint8 stages[FILTER_MAX_STAGES];
+	int count = 0;
+	char names[128];
+
+	strncpy(names, list, sizeof(names) - 1);
+	names[sizeof(names) - 1] = 0;
+
+	for (char *tok = strtok(names, ","); tok; tok = strtok(NULL, ","))
+	{
+		int s = S9xFilterStageByName(tok);
+
+		if (s < 0 || count == FILTER_MAX_STAGES)
+			return false;
+
+		stages[count++] = s;
+	}
+
+	if (!S9xFilterPipelineInit(&filterPipeline, stages, count))
+		return false;
+
+	int scale = S9xFilterPipelineScale(&filterPipeline);
+
+	filterOut = (uint16 *) malloc(MAX_SNES_WIDTH * scale * MAX_SNES_HEIGHT * scale * sizeof(uint16));
+	if (!filterOut)
+		return false;
+
+#ifdef FILTER_THREAD
+	filterThreaded = threaded && S9xFilterPipelineStartThread(&filterPipeline);
+#else
+	if (threaded)
+		fprintf(stderr, "-filterthread needs a FILTER_THREAD build (make linux FILTERTHREAD=1)\n");
+#endif
+
+	return true;
+}
+
+/****************************************************************************
+ * HeadlessFilterFrame
+ *
+ * Called for every displayed frame. Only the time the emulation thread
+ * spends here counts towards HeadlessStats.filterNS.
+ ***************************************************************************/
+void HeadlessFilterFrame(int Width, int Height)
+{
+	if (!filterOut)
+		return;
+
+	uint64 start = HeadlessTimeNS();
+	uint32 outPitch = Width * S9xFilterPipelineScale(&filterPipeline) * sizeof(uint16);
+
+#ifdef FILTER_THREAD
+	if (filterThreaded)
+		S9xFilterPipelineSubmit(&filterPipeline, (uint8 *) GFX.Screen, GFX.Pitch, (uint8 *) filterOut, outPitch, Width, Height);
+	else
+#endif
+	S9xFilterPipelineRun(&filterPipeline, (uint8 *) GFX.Screen, GFX.Pitch, (uint8 *) filterOut, outPitch, Width, Height);
+
+	HeadlessStats.filterNS += HeadlessTimeNS() - start;
+	HeadlessStats.filterWidth = Width;
+	HeadlessStats.filterHeight = Height;
+	HeadlessStats.filterCost = S9xFilterPipelineCost(&filterPipeline, Width, Height);
+}
+
+/****************************************************************************
+ * HeadlessFilterFinish
+ *
+ * Waits for the last frame and checksums it into HeadlessStats.filterCRC.
+ ***************************************************************************/
+void HeadlessFilterFinish()
+{
+	if (!filterOut)
+		return;
+
+#ifdef FILTER_THREAD
+	uint64 start = HeadlessTimeNS();
+
+	S9xFilterPipelineWait(&filterPipeline);
+	HeadlessStats.filterNS += HeadlessTimeNS() - start;
+#endif
+
+	int scale = S9xFilterPipelineScale(&filterPipeline);
+	uint32 bytes = HeadlessStats.filterWidth * scale * HeadlessStats.filterHeight * scale * sizeof(uint16);
+
+	HeadlessStats.filterCRC = crc32(0, (uint8 *) filterOut, bytes);
+
+	S9xFilterPipelineDeinit(&filterPipeline);
+	free(filterOut);
+	filterOut = NULL;
+}
@@ -0,0 +1,527 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * headless.cpp
+ *
+ * Headless host target. Loads a ROM, runs a fixed number of frames as fast
+ * as possible with optional scripted input, and reports core throughput.
+ *
+ * Usage: snes9xfx-headless [options] rom.sfc
+ *   -frames N    frames to time (default 600)
+ *   -warmup N    frames to run before timing starts (default 0)
+ *   -skip N      render one frame out of N+1 (Settings.SkipFrames)
+ *   -turbo       enable Settings.TurboMode (uses Settings.TurboSkipFrames)
+ *   -turboskip N enable Settings.TurboMode with Settings.TurboSkipFrames N;
+ *                the "frame cost" line splits the time between rendered
+ *                and skipped frames
+ *   -mute        run with Settings.Mute set
+ *   -input FILE  scripted input for joypad 1, see LoadInputScript
+ *   -profile FILE  write per-frame profiler data as CSV (PROFILER builds)
+ *   -opstats FILE  write the opcode histogram report, "-" for stdout
+ *                  (OPCODE_STATS builds)
+ *   -cpubench N  time N opcodes per opcode table instead of running frames,
+ *                see cpubench.cpp
+ *   -dspbench N  time N S-DSP samples per interpolation method, see
+ *                dspbench.cpp (no ROM needed)
+ *   -resampler hermite|sinc  output resampler (Settings.ResamplerMethod)
+ *   -resamplebench N  time N output frames per resampler and measure
+ *                THD+N, imaging and aliasing, see resamplebench.cpp
+ *                (no ROM needed)
+ *   -tilebench N decode all of VRAM N times per tile converter, see
+ *                tilebench.cpp (no ROM needed)
+ *   -filter LIST run every displayed frame through the filter stages in
+ *                LIST, e.g. scale2x,scanlines, see filterpipe.h
+ *   -filterthread  filter on a worker thread (FILTER_THREAD builds)
+ *   -filterbench N  time each filter stage over N frames, see
+ *                filterbench.cpp (no ROM needed)
+ *   -present MODE  copy every displayed frame into a texture and time it,
+ *                MODE is tiled, tiled-copy, linear-copy or linear, see
+ *                presentbench.cpp
+ *   -rewind MB   keep a rewind buffer of MB megabytes and time capturing
+ *                states, see rewindbench.cpp
+ *   -rewindinterval N  capture a state every N frames (default 1)
+ *   -rewindthread  encode states on a worker thread (REWIND_THREAD builds)
+ *   -rewindcheck pop every state held at the end and compare it with the
+ *                state that was captured
+ *   -snapbench N after the timed frames, save and load a snapshot N times
+ *                per format, see snapshotbench.cpp
+ *   -runahead N  run N frames ahead (runahead.h); the "runahead" line gives
+ *                the cost per frame against the frame time
+ *   -renderthreads N  render scanline bands on N extra threads
+ *                (Settings.RenderThreads, RENDER_THREADS builds)
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/memmap.h"
+#include "snes9x/apu/apu.h"
+#include "snes9x/apu/resampler.h"
+#include "snes9x/controls.h"
+#include "snes9x/display.h"
+#include "snes9x/gfx.h"
+#include "snes9x/ppu.h"
+#include "snes9x/tile.h"
+#include "snes9x/profiler.h"
+#include "snes9x/opstats.h"
+#include "snes9x/runahead.h"
+
+#define SCREEN_PITCH	(MAX_SNES_WIDTH * 2)
+
+static const char *buttonNames[HEADLESS_PAD_BUTTONS] =
+{
+	"A", "B", "X", "Y", "L", "R", "Start", "Select", "Up", "Down", "Left", "Right"
+};
+
+struct InputEvent
+{
+	uint32 frame;
+	uint16 buttons; // bit n set = buttonNames[n] held
+};
+
+static std::vector<InputEvent> inputScript;
+static uint16 *screenBuffer = NULL;
+
+/****************************************************************************
+ * DefaultSettings
+ *
+ * Same core settings the Wii/GameCube port uses by default (preferences.cpp)
+ ***************************************************************************/
+static void DefaultSettings()
+{
+	memset (&Settings, 0, sizeof (Settings));
+
+	Settings.DontSaveOopsSnapshot = true;
+	Settings.ApplyCheats = true;
+	Settings.NoPatch = true;
+
+	Settings.HDMATimingHack = 100;
+
+	Settings.SoundSync = true;
+	Settings.SixteenBitSound = true;
+	Settings.Stereo = true;
+	Settings.ReverseStereo = true;
+	Settings.SoundPlaybackRate = 48000;
+	Settings.SoundInputRate = 31920;
+	Settings.DynamicRateControl = true;
+	Settings.InterpolationMethod = DSP_INTERPOLATION_GAUSSIAN;
+
+	Settings.Transparency = true;
+	Settings.SupportHiRes = true;
+	Settings.TurboSkipFrames = 19;
+
+	Settings.FrameTimePAL = 20000;
+	Settings.FrameTimeNTSC = 16667;
+
+	Settings.BlockInvalidVRAMAccessMaster = true;
+
+	Settings.SuperFXSpeedPerLine = 5823405;
+	Settings.SuperFXClockMultiplier = 100;
+
+	Settings.OneClockCycle = 6;
+	Settings.OneSlowClockCycle = 8;
+	Settings.TwoClockCycles = 12;
+
+	Settings.MaxSpriteTilesPerLine = 34;
+}
+
+static void SetupInput()
+{
+	s9xcommand_t cmd;
+	char name[32];
+
+	S9xUnmapAllControls();
+
+	for (int i = 0; i < HEADLESS_PAD_BUTTONS; i++)
+	{
+		sprintf(name, "Joypad1 %s", buttonNames[i]);
+		S9xMapButton(HEADLESS_PAD_BASE + i, cmd = S9xGetCommandT(name), false);
+	}
+
+	S9xSetController(0, CTL_JOYPAD, 0, 0, 0, 0);
+	S9xSetController(1, CTL_JOYPAD, 1, 0, 0, 0);
+	S9xVerifyControllers();
+}
+
+/****************************************************************************
+ * LoadInputScript
+ *
+ * One event per line: "<frame> <buttons>", where buttons is a list of
+ * button names joined with '+' (e.g. "120 Start", "300 A+Right"), or
+ * "none". The state is held until the next event. Lines starting with '#'
+ * are ignored.
+ ***************************************************************************/
+static bool LoadInputScript(const char *filename)
+{
+	FILE *fp = fopen(filename, "r");
+
+	if (!fp)
+		return false;
+
+	char line[256];
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		InputEvent ev;
+		char buttons[224];
+
+		if (line[0] == '#' || sscanf(line, "%u %223s", &ev.frame, buttons) != 2)
+			continue;
+
+		ev.buttons = 0;
+
+		for (char *tok = strtok(buttons, "+"); tok; tok = strtok(NULL, "+"))
+		{
+			for (int i = 0; i < HEADLESS_PAD_BUTTONS; i++)
+			{
+				if (strcasecmp(tok, buttonNames[i]) == 0)
+					ev.buttons |= 1 << i;
+			}
+		}
+
+		inputScript.push_back(ev);
+	}
+
+	fclose(fp);
+	return true;
+}
+
+static void ApplyInput(uint32 frame)
+{
+	static size_t next = 0;
+
+	while (next < inputScript.size() && inputScript[next].frame <= frame)
+	{
+		for (int i = 0; i < HEADLESS_PAD_BUTTONS; i++)
+			S9xReportButton(HEADLESS_PAD_BASE + i, (inputScript[next].buttons >> i) & 1);
+		next++;
+	}
+}
+
+static bool InitializeSnes9x()
+{
+	if (!Memory.Init() || !S9xInitAPU())
+		return false;
+
+	S9xInitSound(64, 0);
+	S9xSetSamplesAvailableCallback(HeadlessAudioCallback, NULL);
+
+	screenBuffer = (uint16 *) calloc(SCREEN_PITCH * MAX_SNES_HEIGHT, 1);
+	GFX.Pitch = SCREEN_PITCH;
+	GFX.Screen = screenBuffer;
+
+	return S9xGraphicsInit();
+}
+
+static void Usage()
+{
+	fprintf(stderr,
+		"usage: snes9xfx-headless [-frames N] [-warmup N] [-skip N] [-turbo] [-turboskip N] [-mute] [-input FILE] [-profile FILE] [-opstats FILE] [-cpubench N] [-dspbench N]\n"
+		"       [-resampler hermite|sinc] [-resamplebench N] [-tilebench N]\n"
+		"       [-filter LIST] [-filterthread] [-filterbench N] [-present MODE]\n"
+		"       [-rewind MB] [-rewindinterval N] [-rewindthread] [-rewindcheck] [-snapbench N] [-runahead N]\n"
+		"       [-renderthreads N] rom\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32 frames = 600;
+	uint32 warmup = 0;
+	uint32 cpubench = 0;
+	uint32 dspbench = 0;
+	uint32 resamplebench = 0;
+	uint32 tilebench = 0;
+	uint32 filterbench = 0;
+	const char *filter = NULL;
+	bool filterthread = false;
+	const char *present = NULL;
+	uint32 rewind = 0;
+	uint32 rewindinterval = 1;
+	bool rewindthread = false;
+	bool rewindcheck = false;
+	uint32 snapbench = 0;
+	uint32 runahead = 0;
+	const char *rom = NULL;
+	const char *script = NULL;
+	const char *profile = NULL;
+	const char *opstats = NULL;
+
+	DefaultSettings();
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-frames") && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-warmup") && i + 1 < argc)
+			warmup = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-skip") && i + 1 < argc)
+			Settings.SkipFrames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-turbo"))
+			Settings.TurboMode = TRUE;
+		else if (!strcmp(argv[i], "-turboskip") && i + 1 < argc)
+		{
+			Settings.TurboMode = TRUE;
+			Settings.TurboSkipFrames = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "-mute"))
+			Settings.Mute = TRUE;
+		else if (!strcmp(argv[i], "-input") && i + 1 < argc)
+			script = argv[++i];
+		else if (!strcmp(argv[i], "-profile") && i + 1 < argc)
+			profile = argv[++i];
+		else if (!strcmp(argv[i], "-opstats") && i + 1 < argc)
+			opstats = argv[++i];
+		else if (!strcmp(argv[i], "-cpubench") && i + 1 < argc)
+			cpubench = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-dspbench") && i + 1 < argc)
+			dspbench = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-resampler") && i + 1 < argc)
+			Settings.ResamplerMethod = strcmp(argv[++i], "sinc") ? RESAMPLER_HERMITE : RESAMPLER_SINC;
+		else if (!strcmp(argv[i], "-resamplebench") && i + 1 < argc)
+			resamplebench = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-tilebench") && i + 1 < argc)
+			tilebench = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-filter") && i + 1 < argc)
+			filter = argv[++i];
+		else if (!strcmp(argv[i], "-filterthread"))
+			filterthread = true;
+		else if (!strcmp(argv[i], "-filterbench") && i + 1 < argc)
+			filterbench = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-present") && i + 1 < argc)
+			present = argv[++i];
+		else if (!strcmp(argv[i], "-rewind") && i + 1 < argc)
+			rewind = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-rewindinterval") && i + 1 < argc)
+			rewindinterval = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-rewindthread"))
+			rewindthread = true;
+		else if (!strcmp(argv[i], "-rewindcheck"))
+			rewindcheck = true;
+		else if (!strcmp(argv[i], "-snapbench") && i + 1 < argc)
+			snapbench = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-runahead") && i + 1 < argc)
+			runahead = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-renderthreads") && i + 1 < argc)
+			Settings.RenderThreads = atoi(argv[++i]);
+		else if (argv[i][0] == '-')
+			Usage();
+		else
+			rom = argv[i];
+	}
+
+	if ((!rom && !dspbench && !resamplebench && !tilebench && !filterbench) || frames == 0)
+		Usage();
+
+#ifndef RENDER_THREADS
+	if (Settings.RenderThreads)
+		fprintf(stderr, "-renderthreads needs a RENDER_THREADS build (make linux RENDERTHREADS=1)\n");
+#endif
+
+	if (script && !LoadInputScript(script))
+	{
+		fprintf(stderr, "Unable to open input script %s\n", script);
+		return 1;
+	}
+
+	if (!InitializeSnes9x())
+	{
+		fprintf(stderr, "Unable to initialize Snes9x\n");
+		return 1;
+	}
+
+	SetupInput();
+
+	if (dspbench)
+	{
+		HeadlessDSPBench(dspbench);
+		return 0;
+	}
+
+	if (resamplebench)
+	{
+		HeadlessResampleBench(resamplebench);
+		return 0;
+	}
+
+	if (tilebench)
+	{
+		HeadlessTileBench(tilebench);
+		return 0;
+	}
+
+	if (filterbench)
+	{
+		HeadlessFilterBench(filterbench);
+		return 0;
+	}
+
+	if (filter && !HeadlessFilterInit(filter, filterthread))
+	{
+		fprintf(stderr, "Unable to set up filter %s\n", filter);
+		return 1;
+	}
+
+	if (present && !HeadlessPresentInit(present))
+	{
+		fprintf(stderr, "Unknown present mode %s\n", present);
+		return 1;
+	}
+
+	if (!Memory.LoadROM(rom))
+	{
+		fprintf(stderr, "Unable to load ROM %s\n", rom);
+		return 1;
+	}
+
+	if (cpubench)
+	{
+		HeadlessCPUBench(cpubench);
+		return 0;
+	}
+
+	if (rewind && !HeadlessRewindInit(rewind, rewindinterval, rewindthread, rewindcheck))
+	{
+		fprintf(stderr, "Unable to set up a %u MB rewind buffer\n", rewind);
+		return 1;
+	}
+
+	if (runahead && !S9xRunAheadInit(runahead))
+	{
+		fprintf(stderr, "Unable to set up run-ahead\n");
+		return 1;
+	}
+
+	uint32 frame = 0;
+
+	for (; frame < warmup; frame++)
+	{
+		ApplyInput(frame);
+		S9xRunAheadFrame();
+	}
+
+	memset(&HeadlessStats, 0, sizeof(HeadlessStats));
+	memset(&APUSyncStats, 0, sizeof(APUSyncStats));
+	memset(&TileCacheStats, 0, sizeof(TileCacheStats));
+	memset(&RunAheadStats, 0, sizeof(RunAheadStats));
+	PROFILE_RESET();
+	OPSTATS_RESET();
+
+	uint64 lines = 0;
+	uint64 renderedNS = 0, skippedNS = 0, worstNS = 0;
+	uint32 skipped = 0;
+	uint64 start = HeadlessTimeNS();
+
+	for (; frame < warmup + frames; frame++)
+	{
+		ApplyInput(frame);
+
+		// S9xSyncSpeed decided at the end of the previous frame
+		bool8 render = IPPU.RenderThisFrame;
+		uint64 t = HeadlessTimeNS();
+		S9xRunAheadFrame();
+		t = HeadlessTimeNS() - t;
+
+		if (t > worstNS)
+			worstNS = t;
+
+		if (render)
+			renderedNS += t;
+		else
+		{
+			skippedNS += t;
+			skipped++;
+		}
+
+		HeadlessRewindFrame();
+
+		lines += Timings.V_Max;
+	}
+
+	HeadlessFilterFinish();
+
+	uint64 elapsed = HeadlessTimeNS() - start;
+	double seconds = elapsed / 1e9;
+
+	printf("rom:          %s\n", Memory.ROMName);
+	printf("frames:       %u (%u rendered, %u displayed)\n", frames,
+		HeadlessStats.renderedFrames, HeadlessStats.displayedFrames);
+	printf("time:         %.3f s\n", seconds);
+	printf("frames/sec:   %.2f\n", frames / seconds);
+	printf("ns/scanline:  %.1f\n", (double) elapsed / lines);
+	printf("frame cost:   %.1f us rendered, %.1f us skipped (%u skipped)\n",
+		frames > skipped ? renderedNS / 1e3 / (frames - skipped) : 0.0,
+		skipped ? skippedNS / 1e3 / skipped : 0.0, skipped);
+	printf("samples:      %llu (%.1f per frame)\n",
+		(unsigned long long) HeadlessStats.samples, (double) HeadlessStats.samples / frames);
+	printf("video crc32:  %08x\n", HeadlessStats.videoCRC);
+	printf("audio crc32:  %08x\n", HeadlessStats.audioCRC);
+	printf("apu batches:  %u (%.1f per frame, %.0f SPC clocks avg), %u port accesses\n",
+		APUSyncStats.Batches, (double) APUSyncStats.Batches / frames,
+		APUSyncStats.Batches ? (double) APUSyncStats.Clocks / APUSyncStats.Batches : 0.0, APUSyncStats.PortAccesses);
+	printf("tile cache:   %u invalidated, %u converted (%.1f, %.1f per rendered frame)\n",
+		TileCacheStats.Invalidations, TileCacheStats.Conversions,
+		HeadlessStats.renderedFrames ? (double) TileCacheStats.Invalidations / HeadlessStats.renderedFrames : 0.0,
+		HeadlessStats.renderedFrames ? (double) TileCacheStats.Conversions / HeadlessStats.renderedFrames : 0.0);
+	if (filter)
+		printf("filter:       %.1f us per displayed frame on the emulation thread (estimate %u cycles), crc32 %08x\n",
+			HeadlessStats.displayedFrames ? HeadlessStats.filterNS / 1e3 / HeadlessStats.displayedFrames : 0.0,
+			HeadlessStats.filterCost, HeadlessStats.filterCRC);
+	if (present)
+		printf("present:      %s, %.1f us per displayed frame, texture crc32 %08x\n", HeadlessPresentMode(),
+			HeadlessStats.displayedFrames ? HeadlessStats.presentNS / 1e3 / HeadlessStats.displayedFrames : 0.0,
+			HeadlessStats.presentCRC);
+
+	if (RunAhead.Frames)
+	{
+		// Only rendered frames run ahead
+		double budgetUS = Settings.PAL ? Settings.FrameTimePAL : Settings.FrameTimeNTSC;
+		double stepUS = frames > skipped ? renderedNS / 1e3 / (frames - skipped) : 0.0;
+
+		printf("runahead:     %d frames, %.1f us per frame (worst %.1f us), %.0f%% of the %.1f ms frame time, %u extra frames emulated\n",
+			RunAhead.Frames, stepUS, worstNS / 1e3, stepUS / budgetUS * 100, budgetUS / 1e3, RunAheadStats.Frames);
+	}
+
+	HeadlessRewindFinish(frames);
+
+	if (snapbench)
+		HeadlessSnapshotBench(snapbench);
+
+#ifdef PROFILER
+	char summary[64];
+
+	S9xProfilerSummary(summary, sizeof(summary), frames < PROFILE_FRAMES ? frames : PROFILE_FRAMES);
+	printf("profile:      %s\n", summary);
+
+	if (profile && !S9xProfilerDumpCSV(profile))
+		fprintf(stderr, "Unable to write profile %s\n", profile);
+#else
+	if (profile)
+		fprintf(stderr, "-profile needs a PROFILER build (make linux PROFILE=1)\n");
+#endif
+
+#ifdef OPCODE_STATS
+	if (opstats)
+	{
+		FILE *fp = strcmp(opstats, "-") ? fopen(opstats, "w") : stdout;
+
+		if (fp)
+		{
+			S9xOpcodeStatsReport(fp, 32);
+			if (fp != stdout)
+				fclose(fp);
+		}
+		else
+			fprintf(stderr, "Unable to write opcode stats %s\n", opstats);
+	}
+#else
+	if (opstats)
+		fprintf(stderr, "-opstats needs an OPCODE_STATS build (make linux OPSTATS=1)\n");
+#endif
+
+	return 0;
+}
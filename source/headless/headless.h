@@ -0,0 +1,55 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * headless.h
+ *
+ * Headless host target - runs the emulation core without video, audio or
+ * input devices so it can be benchmarked off-console
+ ***************************************************************************/
+
+#ifndef _HEADLESS_H_
+#define _HEADLESS_H_
+
+#include "snes9x/snes9x.h"
+
+#define HEADLESS_PAD_BUTTONS	12
+#define HEADLESS_PAD_BASE		0x10 // same button ids as SetDefaultButtonMap
+
+struct SHeadlessStats
+{
+	uint64	samples;		// 16-bit stereo frames drained from the resampler
+	uint32	renderedFrames;	// frames where IPPU.RenderThisFrame was set
+	uint32	displayedFrames;// calls to S9xDeinitUpdate
+	uint32	audioCRC;		// crc32 of every mixed sample
+	uint32	videoCRC;		// crc32 of the last displayed frame
+	uint64	filterNS;		// emulation thread time spent in -filter
+	uint32	filterCost;		// S9xFilterPipelineCost of the last frame
+	uint32	filterCRC;		// crc32 of the last filtered frame
+	int		filterWidth;	// size of the last frame filtered
+	int		filterHeight;
+	uint64	presentNS;		// time spent getting frames into the -present texture
+	uint32	presentCRC;		// crc32 of the texture after the last frame
+	uint64	rewindNS;		// emulation thread time spent capturing -rewind states
+};
+
+extern struct SHeadlessStats	HeadlessStats;
+
+uint64 HeadlessTimeNS();
+void HeadlessAudioCallback(void *data);
+void HeadlessCPUBench(uint32 ops);
+void HeadlessDSPBench(uint32 samples);
+void HeadlessResampleBench(uint32 frames);
+void HeadlessTileBench(uint32 passes);
+void HeadlessFilterBench(uint32 passes);
+bool HeadlessFilterInit(const char *list, bool threaded);
+void HeadlessFilterFrame(int Width, int Height);
+void HeadlessFilterFinish();
+bool HeadlessPresentInit(const char *mode);
+const char *HeadlessPresentMode();
+void HeadlessPresentFrame(int Width, int Height);
+bool HeadlessRewindInit(uint32 megabytes, uint32 interval, bool threaded, bool check);
+void HeadlessRewindFrame();
+void HeadlessRewindFinish(uint32 frames);
+void HeadlessSnapshotBench(uint32 passes);
+
+#endif
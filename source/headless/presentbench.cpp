@@ -0,0 +1,112 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * presentbench.cpp
+ *
+ * The -present hook, which times getting every displayed frame into a host
+ * texture:
+ *   tiled        the core writes each band into a 4x4 tiled texture as it
+ *                finishes it (S9xSetPresentTarget, as on GX)
+ *   tiled-copy   the whole frame is tiled after S9xDeinitUpdate, as
+ *                MakeTexture does
+ *   linear-copy  the whole frame is copied row by row after S9xDeinitUpdate
+ *   linear       the core draws into the texture itself (GFX.Screen), so
+ *                there is nothing to time
+ * Both tiled modes must give the same texture checksum.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/ppu.h"
+#include "snes9x/gfx.h"
+
+enum
+{
+	PRESENT_MODE_TILED,
+	PRESENT_MODE_TILED_COPY,
+	PRESENT_MODE_LINEAR_COPY,
+	PRESENT_MODE_LINEAR
+};
+
+static const char *presentModes[] = { "tiled", "tiled-copy", "linear-copy", "linear" };
+
+static int presentMode = -1;
+static uint16 *texture = NULL;
+
+static void TimedPresentLines(uint32 first, uint32 last)
+{
+	uint64 start = HeadlessTimeNS();
+
+	S9xPresentTiled4x4(first, last);
+	HeadlessStats.presentNS += HeadlessTimeNS() - start;
+}
+
+/****************************************************************************
+ * HeadlessPresentInit
+ ***************************************************************************/
+bool HeadlessPresentInit(const char *mode)
+{
+	for (int m = 0; m < 4; m++)
+	{
+		if (!strcmp(mode, presentModes[m]))
+			presentMode = m;
+	}
+
+	if (presentMode < 0)
+		return false;
+
+	texture = (uint16 *) calloc(MAX_SNES_WIDTH * MAX_SNES_HEIGHT, sizeof(uint16));
+	if (!texture)
+		return false;
+
+	if (presentMode == PRESENT_MODE_TILED)
+	{
+		S9xSetPresentTarget(PRESENT_TILED4X4, texture);
+		GFX.PresentLines = TimedPresentLines;
+	}
+
+	return true;
+}
+
+const char *HeadlessPresentMode()
+{
+	return presentMode < 0 ? NULL : presentModes[presentMode];
+}
+
+/****************************************************************************
+ * HeadlessPresentFrame
+ *
+ * Called for every displayed frame
+ ***************************************************************************/
+void HeadlessPresentFrame(int Width, int Height)
+{
+	if (presentMode < 0)
+		return;
+
+	uint64 start = HeadlessTimeNS();
+
+	switch (presentMode)
+	{
+		case PRESENT_MODE_TILED_COPY:
+			GFX.PresentTexture = texture;
+			S9xPresentTiled4x4(0, Height - 1);
+			break;
+
+		case PRESENT_MODE_LINEAR_COPY:
+			for (int y = 0; y < Height; y++)
+				memcpy(texture + y * Width, GFX.Screen + y * GFX.RealPPL, Width * sizeof(uint16));
+			break;
+	}
+
+	HeadlessStats.presentNS += HeadlessTimeNS() - start;
+
+	if (presentMode == PRESENT_MODE_LINEAR)
+		HeadlessStats.presentCRC = HeadlessStats.videoCRC;
+	else
+		HeadlessStats.presentCRC = crc32(0, (uint8 *) texture, Width * Height * sizeof(uint16));
+}
@@ -0,0 +1,193 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * resamplebench.cpp
+ *
+ * Output resampler benchmark. For each Resampler method, times the DSP rate
+ * to playback rate conversion used by S9xMixSamples and measures quality
+ * with test tones:
+ *   THD+N     1 kHz at -6 dBFS, everything but the fitted tone
+ *   imaging   10 kHz tone, level of its image above the input Nyquist rate
+ *   aliasing  14 kHz tone resampled to 22.05 kHz, level folded back in band
+ * Levels are in dB relative to the input tone.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/apu/resampler.h"
+
+#define BENCH_CHUNK		1024	// stereo frames pushed at a time
+#define FIT_SKIP		512		// output frames ignored while the filters settle
+#define FIT_FRAMES		16384
+#define TONE_LEVEL		16384.0
+
+struct BenchMethod
+{
+	const char *name;
+	int method;
+};
+
+static const BenchMethod benchMethods[] =
+{
+	{ "hermite", RESAMPLER_HERMITE },
+	{ "sinc",    RESAMPLER_SINC    }
+};
+
+static int16 input[BENCH_CHUNK * 2];
+static int16 output[BENCH_CHUNK * 8];
+static float fitted[FIT_SKIP + FIT_FRAMES];
+
+/****************************************************************************
+ * Resample
+ *
+ * Feeds a tone of 'freq' Hz at 'inRate' through 'r' and keeps the left
+ * channel of the first 'frames' output frames in 'dst'. Returns the number
+ * of output frames produced. With dst NULL it only counts (benchmark).
+ ***************************************************************************/
+static uint32 Resample(Resampler &r, double freq, double inRate, float *dst, uint32 frames)
+{
+	uint32 produced = 0;
+	uint64 phase = 0;
+
+	r.clear();
+
+	while (produced < frames)
+	{
+		for (int i = 0; i < BENCH_CHUNK; i++, phase++)
+			input[i * 2] = input[i * 2 + 1] = (int16) lrint(TONE_LEVEL * sin(2 * M_PI * freq * phase / inRate));
+
+		r.push(input, BENCH_CHUNK * 2);
+
+		int avail = r.avail();
+
+		while (avail > 0)
+		{
+			int n = avail < (int) (sizeof(output) / sizeof(output[0])) ? avail : sizeof(output) / sizeof(output[0]);
+
+			r.read(output, n);
+			avail -= n;
+
+			for (int i = 0; i < n && dst; i += 2)
+				if (produced + i / 2 < frames)
+					dst[produced + i / 2] = output[i];
+
+			produced += n / 2;
+		}
+	}
+
+	return produced;
+}
+
+/****************************************************************************
+ * FitTone
+ *
+ * Least-squares fit of a*sin + b*cos + c at normalized angular frequency w.
+ * Returns the tone amplitude; 'residual' gets the RMS of what's left.
+ ***************************************************************************/
+static double FitTone(const float *y, int n, double w, double *residual)
+{
+	double m[3][3] = { { 0 } }, v[3] = { 0 };
+
+	for (int i = 0; i < n; i++)
+	{
+		double b[3] = { sin(w * i), cos(w * i), 1.0 };
+
+		for (int j = 0; j < 3; j++)
+		{
+			for (int k = 0; k < 3; k++)
+				m[j][k] += b[j] * b[k];
+			v[j] += b[j] * y[i];
+		}
+	}
+
+	// Cramer's rule on the 3x3 normal equations
+	#define DET(a) ((a)[0][0] * ((a)[1][1] * (a)[2][2] - (a)[1][2] * (a)[2][1]) - \
+					(a)[0][1] * ((a)[1][0] * (a)[2][2] - (a)[1][2] * (a)[2][0]) + \
+					(a)[0][2] * ((a)[1][0] * (a)[2][1] - (a)[1][1] * (a)[2][0]))
+
+	double d = DET(m), x[3];
+
+	for (int j = 0; j < 3; j++)
+	{
+		double t[3][3];
+
+		memcpy(t, m, sizeof(t));
+		for (int k = 0; k < 3; k++)
+			t[k][j] = v[k];
+		x[j] = DET(t) / d;
+	}
+
+	#undef DET
+
+	if (residual)
+	{
+		double sum = 0;
+
+		for (int i = 0; i < n; i++)
+		{
+			double e = y[i] - (x[0] * sin(w * i) + x[1] * cos(w * i) + x[2]);
+			sum += e * e;
+		}
+
+		*residual = sqrt(sum / n);
+	}
+
+	return sqrt(x[0] * x[0] + x[1] * x[1]);
+}
+
+static double ToneDB(double level)
+{
+	return 20 * log10(level / TONE_LEVEL + 1e-12);
+}
+
+/****************************************************************************
+ * HeadlessResampleBench
+ *
+ * Times 'frames' output frames per method at the configured input and
+ * playback rates, then prints the quality measurements.
+ ***************************************************************************/
+void HeadlessResampleBench(uint32 frames)
+{
+	int methods = sizeof(benchMethods) / sizeof(benchMethods[0]);
+	double inRate = Settings.SoundInputRate;
+	double outRate = Settings.SoundPlaybackRate;
+	double up = inRate / outRate;
+	double down = 32040.0 / 22050.0;
+
+	printf("resampler benchmark: %u output frames per method, %.0f -> %.0f Hz\n", frames, inRate, outRate);
+
+	for (int m = 0; m < methods; m++)
+	{
+		Resampler r(BENCH_CHUNK * 8);
+		double noise, level;
+
+		r.set_method(benchMethods[m].method);
+		r.time_ratio(up);
+
+		uint64 start = HeadlessTimeNS();
+		uint32 done = Resample(r, 1000.0, inRate, NULL, frames);
+		uint64 elapsed = HeadlessTimeNS() - start;
+
+		printf("  %-8s %7.2f Mframes/s", benchMethods[m].name, done * 1e3 / elapsed);
+
+		// THD+N
+		Resample(r, 1000.0, inRate, fitted, FIT_SKIP + FIT_FRAMES);
+		level = FitTone(fitted + FIT_SKIP, FIT_FRAMES, 2 * M_PI * 1000.0 * up / inRate, &noise);
+		printf("  THD+N %6.1f dB", 20 * log10(noise / level));
+
+		// Imaging: the 10 kHz tone's mirror around the input rate
+		Resample(r, 10000.0, inRate, fitted, FIT_SKIP + FIT_FRAMES);
+		level = FitTone(fitted + FIT_SKIP, FIT_FRAMES, 2 * M_PI * (inRate - 10000.0) * up / inRate, NULL);
+		printf("  imaging %6.1f dB", ToneDB(level));
+
+		// Aliasing: 14 kHz is above the 22.05 kHz output's Nyquist rate
+		r.time_ratio(down);
+		Resample(r, 14000.0, 32040.0, fitted, FIT_SKIP + FIT_FRAMES);
+		level = FitTone(fitted + FIT_SKIP, FIT_FRAMES, 2 * M_PI * 14000.0 * down / 32040.0, NULL);
+		printf("  aliasing %6.1f dB\n", ToneDB(level));
+	}
+}
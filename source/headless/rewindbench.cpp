@@ -0,0 +1,137 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * rewindbench.cpp
+ *
+ * The -rewind hook, which keeps a rewind buffer (rewind.h) while the ROM
+ * runs and times what capturing states costs the emulation thread. With
+ * -rewindcheck every state is also checksummed when it is captured, and at
+ * the end all the states still held are popped and compared against those
+ * checksums.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <zlib.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/snapshot.h"
+#include "snes9x/rewind.h"
+
+static bool rewindActive = false;
+static bool rewindCheck = false;
+static uint8 *checkState = NULL;
+static std::vector<uint32> checkCRC;
+
+static uint32 StateCRC()
+{
+	uint32 size = S9xRewindStateSize();
+
+	S9xMemSnapshotSave(checkState);
+
+	return crc32(0, checkState, size);
+}
+
+/****************************************************************************
+ * HeadlessRewindInit
+ *
+ * Called once the ROM is loaded. 'megabytes' is the memory budget, and a
+ * state is captured every 'interval' frames.
+ ***************************************************************************/
+bool HeadlessRewindInit(uint32 megabytes, uint32 interval, bool threaded, bool check)
+{
+	if (!S9xRewindInit(megabytes << 20, interval))
+		return false;
+
+#ifdef REWIND_THREAD
+	if (threaded && !S9xRewindStartThread())
+		return false;
+#else
+	if (threaded)
+		fprintf(stderr, "-rewindthread needs a REWIND_THREAD build (make linux REWINDTHREAD=1)\n");
+#endif
+
+	if (check && !(checkState = (uint8 *) malloc(S9xRewindStateSize())))
+		return false;
+
+	rewindActive = true;
+	rewindCheck = check;
+
+	return true;
+}
+
+/****************************************************************************
+ * HeadlessRewindFrame
+ *
+ * Called after every emulated frame. Only S9xRewindFrame counts towards
+ * HeadlessStats.rewindNS.
+ ***************************************************************************/
+void HeadlessRewindFrame()
+{
+	if (!rewindActive)
+		return;
+
+	uint64 start = HeadlessTimeNS();
+	bool8 captured = S9xRewindFrame();
+
+	HeadlessStats.rewindNS += HeadlessTimeNS() - start;
+
+	if (captured && rewindCheck)
+		checkCRC.push_back(StateCRC());
+}
+
+/****************************************************************************
+ * HeadlessRewindFinish
+ *
+ * Prints the rewind line, then pops every state for -rewindcheck
+ ***************************************************************************/
+void HeadlessRewindFinish(uint32 frames)
+{
+	if (!rewindActive)
+		return;
+
+	uint32 held = S9xRewindCount();
+	uint32 used = S9xRewindBytesUsed();
+	uint32 stored = RewindStats.Captures > 1 ? RewindStats.Captures - 1 : 0;
+
+	printf("rewind:       %u states held (%u captured, %u dropped), %u bytes per state (%u whole), %.2f MB of deltas\n",
+		held, RewindStats.Captures, RewindStats.Dropped,
+		stored ? (uint32) (RewindStats.Bytes / stored) : 0, S9xRewindStateSize(), used / 1048576.0);
+	// What a capture costs without the delta, for comparison
+	uint8 *state = (uint8 *) malloc(S9xRewindStateSize());
+	uint64 freezeStart = HeadlessTimeNS();
+
+	for (int n = 0; n < 16; n++)
+		S9xMemSnapshotSave(state);
+
+	double freezeUS = (HeadlessTimeNS() - freezeStart) / 1e3 / 16;
+	free(state);
+
+	printf("rewind cost:  %.1f us per frame, %.1f us per capture (S9xMemSnapshotSave alone %.1f us)\n",
+		frames ? HeadlessStats.rewindNS / 1e3 / frames : 0.0,
+		RewindStats.Captures ? HeadlessStats.rewindNS / 1e3 / RewindStats.Captures : 0.0, freezeUS);
+
+	if (rewindCheck)
+	{
+		uint32 bad = 0;
+		uint64 start = HeadlessTimeNS();
+
+		for (uint32 n = 0; n < held; n++)
+		{
+			if (!S9xRewindPop() || StateCRC() != checkCRC[checkCRC.size() - 1 - n])
+				bad++;
+		}
+
+		printf("rewind check: %u states popped and checked, %.1f us each, %u mismatched\n", held,
+			held ? (HeadlessTimeNS() - start) / 1e3 / held : 0.0, bad);
+
+		free(checkState);
+		checkState = NULL;
+	}
+
+	S9xRewindDeinit();
+	rewindActive = false;
+}
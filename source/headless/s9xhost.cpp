@@ -0,0 +1,249 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * s9xhost.cpp
+ *
+ * Snes9x support functions for the headless host target. These mirror
+ * s9xsupport.cpp, minus everything that talks to libogc.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "headless.h"
+#include "snes9x/port.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/memmap.h"
+#include "snes9x/display.h"
+#include "snes9x/apu/apu.h"
+#include "snes9x/controls.h"
+#include "snes9x/gfx.h"
+
+#define SAMPLES_TO_PROCESS 1024
+
+struct SHeadlessStats HeadlessStats;
+bool bsxBiosLoadFailed = false;
+
+uint64 HeadlessTimeNS()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*** Miscellaneous Functions ***/
+void S9xExit()
+{
+	exit(0);
+}
+
+void S9xMessage(int /*type */, int /*number */, const char *message)
+{
+	fprintf(stderr, "%s\n", message);
+}
+
+void S9xAutoSaveSRAM()
+{
+
+}
+
+/*** Sound based functions ***/
+void S9xToggleSoundChannel(int c)
+{
+	static int sound_switch = 255;
+
+	if (c == 8)
+		sound_switch = 255;
+	else
+		sound_switch ^= 1 << c;
+
+	S9xSetSoundControl (sound_switch);
+}
+
+bool8 S9xOpenSoundDevice(void)
+{
+	return TRUE;
+}
+
+/****************************************************************************
+ * HeadlessAudioCallback
+ *
+ * Drains the resampler the same way audio.cpp does, but into a scratch
+ * buffer, so the full sound path is exercised and counted.
+ ***************************************************************************/
+void HeadlessAudioCallback(void *data)
+{
+	static uint8 buffer[SAMPLES_TO_PROCESS * 2];
+
+	S9xFinalizeSamples();
+
+	while (S9xGetSampleCount() >= SAMPLES_TO_PROCESS)
+	{
+		S9xMixSamples(buffer, SAMPLES_TO_PROCESS);
+		HeadlessStats.audioCRC = crc32(HeadlessStats.audioCRC, buffer, sizeof(buffer));
+		HeadlessStats.samples += SAMPLES_TO_PROCESS >> 1;
+	}
+}
+
+/*** Synchronisation ***/
+
+void S9xSyncSpeed ()
+{
+	// Never throttle: behave as if the frame timer has always expired
+	uint32 skipFrms = Settings.SkipFrames;
+
+	if (Settings.TurboMode)
+		skipFrms = Settings.TurboSkipFrames;
+
+	if (IPPU.SkippedFrames < skipFrms)
+	{
+		IPPU.SkippedFrames++;
+		IPPU.RenderThisFrame = FALSE;
+	}
+	else
+	{
+		IPPU.SkippedFrames = 0;
+		IPPU.RenderThisFrame = TRUE;
+		HeadlessStats.renderedFrames++;
+	}
+}
+
+/*** Video / Display related functions ***/
+bool8 S9xInitUpdate()
+{
+	return (TRUE);
+}
+
+bool8 S9xDeinitUpdate(int Width, int Height)
+{
+	HeadlessStats.displayedFrames++;
+	HeadlessStats.videoCRC = 0;
+
+	for (int y = 0; y < Height; y++)
+		HeadlessStats.videoCRC = crc32(HeadlessStats.videoCRC, (uint8 *) (GFX.Screen + y * GFX.RealPPL), Width * 2);
+
+	HeadlessFilterFrame(Width, Height);
+	HeadlessPresentFrame(Width, Height);
+
+	return (TRUE);
+}
+
+bool8 S9xContinueUpdate(int Width, int Height)
+{
+	return (TRUE);
+}
+
+/*** Input functions ***/
+void S9xHandlePortCommand(s9xcommand_t cmd, int16 data1, int16 data2)
+{
+	return;
+}
+
+bool S9xPollButton(uint32 id, bool * pressed)
+{
+	return 0;
+}
+
+bool S9xPollAxis(uint32 id, int16 * value)
+{
+	return 0;
+}
+
+bool S9xPollPointer(uint32 id, int16 * x, int16 * y)
+{
+	return 0;
+}
+
+/*** File functions ***/
+bool8 S9xOpenSnapshotFile(const char *filepath, bool8 readonly, STREAM *file)
+{
+	return FALSE;
+}
+
+void S9xCloseSnapshotFile(STREAM s)
+{
+
+}
+
+const char * S9xGetDirectory(enum s9x_getdirtype dirtype)
+{
+	return ".";
+}
+
+const char * S9xGetFilename(const char *ex, enum s9x_getdirtype dirtype)
+{
+	static char	filename[PATH_MAX + 1];
+	char		drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	_splitpath(Memory.ROMFilename, drive, dir, fname, ext);
+	_makepath(filename, drive, dir, fname, NULL);
+	strcat(filename, ex);
+	return filename;
+}
+
+const char * S9xGetFilenameInc(const char *e, enum s9x_getdirtype dirtype)
+{
+	return S9xGetFilename(e, dirtype);
+}
+
+const char * S9xBasename(const char *name)
+{
+	const char *p = strrchr(name, SLASH_CHAR);
+	return p ? p + 1 : name;
+}
+
+const char * S9xStringInput (const char * s)
+{
+	return NULL;
+}
+
+void _splitpath(char const *path, char *drive, char *dir, char *fname, char *ext)
+{
+	const char *slash = strrchr(path, SLASH_CHAR);
+	const char *dot   = strrchr(path, '.');
+
+	if (dot && slash && dot < slash)
+		dot = NULL;
+
+	*drive = 0;
+	*dir = 0;
+	*ext = 0;
+
+	if (slash)
+	{
+		strncpy(dir, path, slash - path);
+		dir[slash - path] = 0;
+		path = slash + 1;
+	}
+
+	strcpy(fname, path);
+
+	if (dot)
+	{
+		fname[dot - path] = 0;
+		strcpy(ext, dot + 1);
+	}
+}
+
+void _makepath(char *filename, const char *drive, const char *dir,
+		const char *fname, const char *ext)
+{
+	*filename = 0;
+
+	if (dir && *dir)
+	{
+		strcpy(filename, dir);
+		strcat(filename, SLASH_STR);
+	}
+
+	strcat(filename, fname);
+
+	if (ext && *ext)
+	{
+		strcat(filename, ".");
+		strcat(filename, ext);
+	}
+}
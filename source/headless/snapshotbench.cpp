@@ -0,0 +1,130 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * snapshotbench.cpp
+ *
+ * Snapshot benchmark. Times saving and loading the running game as a .frz
+ * image (S9xFreezeGameMem) and as an in-memory image (S9xMemSnapshotSave),
+ * then checks that after loading each image the next frames come out the
+ * same as they did the first time.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/memmap.h"
+#include "snes9x/cpuexec.h"
+#include "snes9x/snapshot.h"
+
+#define CHECK_FRAMES	60
+
+enum
+{
+	SNAP_FRZ,
+	SNAP_MEM
+};
+
+static uint32 imageSize[2];
+
+static void Save(int format, uint8 *buf)
+{
+	if (format == SNAP_FRZ)
+		S9xFreezeGameMem(buf, imageSize[SNAP_FRZ]);
+	else
+		S9xMemSnapshotSave(buf);
+}
+
+static bool Load(int format, const uint8 *buf)
+{
+	if (format == SNAP_MEM)
+		return S9xMemSnapshotLoad(buf, imageSize[SNAP_MEM]) == SUCCESS;
+
+	// As rewind used it before the in-memory format
+	bool8 fast = Settings.FastSavestates;
+
+	Settings.FastSavestates = TRUE;
+	int result = S9xUnfreezeGameMem(buf, imageSize[SNAP_FRZ]);
+	Settings.FastSavestates = fast;
+
+	return result == SUCCESS;
+}
+
+/****************************************************************************
+ * RunFrames
+ *
+ * Runs CHECK_FRAMES frames and returns a checksum of every displayed frame
+ * and of the state they end in
+ ***************************************************************************/
+static uint32 RunFrames(uint8 *image)
+{
+	uint32 crc = 0;
+
+	for (int f = 0; f < CHECK_FRAMES; f++)
+	{
+		S9xMainLoop();
+		crc = crc32(crc, (uint8 *) &HeadlessStats.videoCRC, sizeof(uint32));
+	}
+
+	S9xMemSnapshotSave(image);
+
+	return crc32(crc, image, imageSize[SNAP_MEM]);
+}
+
+/****************************************************************************
+ * HeadlessSnapshotBench
+ *
+ * Called after the timed frames, so the game is somewhere in the middle
+ ***************************************************************************/
+void HeadlessSnapshotBench(uint32 passes)
+{
+	static const char *names[2] = { ".frz", "memory" };
+
+	uint64 start = HeadlessTimeNS();
+	imageSize[SNAP_FRZ] = S9xFreezeSize();
+	double frzSizeUS = (HeadlessTimeNS() - start) / 1e3;
+
+	start = HeadlessTimeNS();
+	imageSize[SNAP_MEM] = S9xMemSnapshotSize();
+	double memSizeUS = (HeadlessTimeNS() - start) / 1e3;
+
+	uint8 *image = (uint8 *) malloc(imageSize[SNAP_FRZ] + imageSize[SNAP_MEM]);
+	uint8 *scratch = (uint8 *) malloc(imageSize[SNAP_MEM]);
+
+	printf("snapshot benchmark: %u passes\n", passes);
+
+	for (int format = SNAP_FRZ; format <= SNAP_MEM; format++)
+	{
+		uint8 *buf = format == SNAP_FRZ ? image : image + imageSize[SNAP_FRZ];
+		bool loaded = true;
+
+		start = HeadlessTimeNS();
+		for (uint32 p = 0; p < passes; p++)
+			Save(format, buf);
+		double saveUS = (HeadlessTimeNS() - start) / 1e3 / passes;
+
+		start = HeadlessTimeNS();
+		for (uint32 p = 0; p < passes; p++)
+			loaded &= Load(format, buf);
+		double loadUS = (HeadlessTimeNS() - start) / 1e3 / passes;
+
+		// Run on from the image twice; both runs must match
+		uint32 crc[2];
+
+		for (int run = 0; run < 2; run++)
+		{
+			loaded &= Load(format, buf);
+			crc[run] = RunFrames(scratch);
+		}
+
+		printf("  %-6s %7u bytes  save %7.1f us  load %7.1f us  size %6.1f us  %s\n", names[format],
+			imageSize[format], saveUS, loadUS, format == SNAP_FRZ ? frzSizeUS : memSizeUS,
+			!loaded ? "(load failed)" : crc[0] == crc[1] ? "(replay matches)" : "(replay differs)");
+	}
+
+	free(image);
+	free(scratch);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ * Snes9x Nintendo Wii/GameCube Port
+ *
+ * tilebench.cpp
+ *
+ * Tile decode benchmark. Fills VRAM with pseudo-random tiles (every eighth
+ * one blank) and converts all of it with each tile converter that
+ * S9xSelectTileConverter can pick, reporting tiles and VRAM bytes per
+ * second.
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "headless.h"
+#include "snes9x/snes9x.h"
+#include "snes9x/memmap.h"
+#include "snes9x/ppu.h"
+#include "snes9x/gfx.h"
+#include "snes9x/tile.h"
+
+struct BenchConverter
+{
+	const char *name;
+	int depth;
+	bool8 hires;
+	bool8 sub;		// with hires, picks the even pixel converter
+};
+
+static const BenchConverter benchConverters[] =
+{
+	{ "2bpp",      2, FALSE, FALSE },
+	{ "4bpp",      4, FALSE, FALSE },
+	{ "8bpp",      8, FALSE, FALSE },
+	{ "2bpp odd",  2, TRUE,  FALSE },
+	{ "2bpp even", 2, TRUE,  TRUE  },
+	{ "4bpp odd",  4, TRUE,  FALSE },
+	{ "4bpp even", 4, TRUE,  TRUE  }
+};
+
+static void FillVRAM()
+{
+	uint32 seed = 7;
+
+	for (int i = 0; i < 0x10000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		Memory.VRAM[i] = (i & 0x1c0) == 0x1c0 ? 0 : seed >> 16;
+	}
+}
+
+/****************************************************************************
+ * HeadlessTileBench
+ *
+ * Decodes the whole of VRAM 'passes' times per converter. The checksum
+ * covers the decoded tiles and the blank flags of the last pass, so
+ * converters can be compared between builds.
+ ***************************************************************************/
+void HeadlessTileBench(uint32 passes)
+{
+	int converters = sizeof(benchConverters) / sizeof(benchConverters[0]);
+
+	printf("tile benchmark: %u passes over 64 KB of VRAM per converter\n", passes);
+
+	FillVRAM();
+
+	for (int c = 0; c < converters; c++)
+	{
+		const BenchConverter &bc = benchConverters[c];
+
+		S9xSelectTileConverter(bc.depth, bc.hires, bc.sub, FALSE);
+
+		uint32 tiles = 0x10000 >> BG.TileShift;
+		uint64 start = HeadlessTimeNS();
+
+		for (uint32 p = 0; p < passes; p++)
+			for (uint32 t = 0; t < tiles; t++)
+				BG.Buffered[t] = BG.ConvertTile(BG.Buffer + (t << 6), t << BG.TileShift, t & 0x3ff);
+
+		uint64 elapsed = HeadlessTimeNS() - start;
+		uint32 crc = crc32(0, BG.Buffer, tiles << 6);
+
+		crc = crc32(crc, BG.Buffered, tiles);
+
+		printf("  %-9s %7.2f Mtiles/s  %7.1f MB/s  (crc %08x)\n", bc.name,
+			(double) tiles * passes * 1e3 / elapsed, (double) passes * 0x10000 * 1e3 / elapsed, crc);
+	}
+}
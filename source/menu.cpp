@@ -3661,6 +3661,7 @@ static int MenuSettingsVideo()
 	sprintf(options.name[i++], "Frame Skipping");
 	sprintf(options.name[i++], "Show Frame Rate");
 	sprintf(options.name[i++], "Show Crosshair");
+	sprintf(options.name[i++], "Run-Ahead");
 	options.length = i;
 
 #ifdef HW_DOL
@@ -3769,6 +3770,12 @@ static int MenuSettingsVideo()
 			case 10:
 				GCSettings.crosshair ^= 1;
 				break;
+
+			case 11:
+				GCSettings.RunAhead++;
+				if (GCSettings.RunAhead > 2)
+					GCSettings.RunAhead = 0;
+				break;
 		}
 
 		if(ret >= 0 || firstRun)
@@ -3813,6 +3820,11 @@ static int MenuSettingsVideo()
 			sprintf (options.value[9], "%s", GCSettings.ShowFrameRate == 1 ? "On" : "Off");
 			sprintf (options.value[10], "%s", GCSettings.crosshair == 1 ? "On" : "Off");
 
+			if(GCSettings.RunAhead)
+				sprintf (options.value[11], "%d %s", GCSettings.RunAhead, GCSettings.RunAhead == 1 ? "frame" : "frames");
+			else
+				sprintf (options.value[11], "Off");
+
 			optionBrowser.TriggerUpdate();
 		}
 
@@ -147,6 +147,7 @@ preparePrefsData ()
 	createXMLSetting("HiResMode", "Hi-Res Mode", toStr(GCSettings.HiResMode));
 	createXMLSetting("FrameSkip", "Frame Skipping", toStr(GCSettings.FrameSkip));
 	createXMLSetting("ShowFrameRate", "Show Frame Rate", toStr(GCSettings.ShowFrameRate));
+	createXMLSetting("RunAhead", "Run-Ahead", toStr(GCSettings.RunAhead));
 	createXMLSetting("crosshair", "Show Crosshair", toStr(GCSettings.crosshair));
 	createXMLSetting("xshift", "Horizontal Video Shift", toStr(GCSettings.xshift));
 	createXMLSetting("yshift", "Vertical Video Shift", toStr(GCSettings.yshift));
@@ -340,6 +341,7 @@ decodePrefsData ()
 			loadXMLSetting(&GCSettings.HiResMode, "HiResMode");
 			loadXMLSetting(&GCSettings.FrameSkip, "FrameSkip");
 			loadXMLSetting(&GCSettings.ShowFrameRate, "ShowFrameRate");
+			loadXMLSetting(&GCSettings.RunAhead, "RunAhead");
 			loadXMLSetting(&GCSettings.crosshair, "crosshair");
 			loadXMLSetting(&GCSettings.xshift, "xshift");
 			loadXMLSetting(&GCSettings.yshift, "yshift");
@@ -531,6 +533,7 @@ DefaultSettings ()
 	GCSettings.HiResMode = 1; // Enabled by default
 	GCSettings.FrameSkip = 1; // Enabled by default
 	GCSettings.ShowFrameRate = 0; // Disabled by default
+	GCSettings.RunAhead = 0; // Disabled by default
 
 	// ROM timing
 	Settings.FrameTimePAL = 20000;
@@ -112,6 +112,18 @@ public:
 	bool check_kon();
 #endif
 
+	// Output state that copy_state() leaves out: clocks not yet counted as
+	// samples, and samples already generated beyond them. Loading it after a
+	// state, before calling set_output(), continues output without a gap.
+	struct output_state_t
+	{
+		int      extra_clocks;
+		int      extra_count;
+		sample_t extra [SPC_DSP::extra_size];
+	};
+	void save_output( output_state_t* );
+	void load_output( output_state_t const* );
+
 //// Snes9x Accessor
 
 	void	spc_allow_time_overflow( bool );
@@ -348,6 +348,23 @@ void SNES_SPC::save_extra()
 	assert( out <= &m.extra_buf [extra_size] );
 }
 
+void SNES_SPC::save_output( output_state_t* out )
+{
+	if ( m.buf_begin )
+		save_extra();
+	
+	out->extra_clocks = m.extra_clocks;
+	out->extra_count  = m.extra_pos - m.extra_buf;
+	memcpy( out->extra, m.extra_buf, out->extra_count * sizeof (sample_t) );
+}
+
+void SNES_SPC::load_output( output_state_t const* in )
+{
+	m.extra_clocks = in->extra_clocks;
+	memcpy( m.extra_buf, in->extra, in->extra_count * sizeof (sample_t) );
+	m.extra_pos = m.extra_buf + in->extra_count;
+}
+
 blargg_err_t SNES_SPC::play( int count, sample_t* out )
 {
 	if ( count )
@@ -426,91 +426,158 @@ static short const sinc [2048] =
    -38,    41,  -328,   718, 15642,   613,  -302,    38,
 };
 
-inline int SPC_DSP::interpolate( voice_t const* v )
-{
-    int out;
-    int const* in = &v->buf [(v->interp_pos >> 12) + v->buf_pos];
+// Interpolation kernels, one per Settings.InterpolationMethod. run() picks
+// the kernel when the setting changes, so the per-sample path doesn't switch.
+// The SIMD versions give exactly the same results as the scalar ones.
+
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+	#define SPC_DSP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define SPC_DSP_NEON 1
+#endif
 
-    switch (Settings.InterpolationMethod)
-    {
-    case 0: // raw
+// cubic and gauss rearranged so the four taps for each fractional position
+// are adjacent, in the order they apply to in [0] to in [3]
+static short cubic_taps [256] [4];
+static short gauss_taps [256] [4];
+
+static void init_interpolation_taps()
+{
+    for ( int offset = 0; offset < 256; offset++ )
     {
-        out = in [0] & ~1;
-        break;
+        cubic_taps [offset] [0] = cubic [offset];
+        cubic_taps [offset] [1] = cubic [offset + 257];
+        cubic_taps [offset] [2] = cubic [256 - offset + 257];
+        cubic_taps [offset] [3] = cubic [256 - offset];
+
+        gauss_taps [offset] [0] = gauss [255 - offset];
+        gauss_taps [offset] [1] = gauss [255 - offset + 256];
+        gauss_taps [offset] [2] = gauss [offset + 256];
+        gauss_taps [offset] [3] = gauss [offset];
     }
+}
 
-    case 1: // linear interpolation
-    {
-        int fract = v->interp_pos & 0xFFF;
-        out  = (0x1000 - fract) * in [0];
-        out +=           fract  * in [1];
-        out >>= 12;
+static inline int const* interpolation_input( SPC_DSP::voice_t const* v )
+{
+    return &v->buf [(v->interp_pos >> 12) + v->buf_pos];
+}
 
-        CLAMP16( out );
-        break;
-    }
+static int interpolate_raw( SPC_DSP::voice_t const* v )
+{
+    return interpolation_input( v ) [0] & ~1;
+}
 
-    case 3: // cubic filter
-    {
-        // Make pointers into cubic based on fractional position between samples
-        int offset = v->interp_pos >> 4 & 0xFF;
-        short const* fwd = cubic       + offset;
-        short const* rev = cubic + 256 - offset; // mirror left half of cubic
-
-        out  = fwd [  0] * in [0];
-        out += fwd [257] * in [1];
-        out += rev [257] * in [2];
-        out += rev [  0] * in [3];
-        out >>= 11;
-
-        CLAMP16( out );
-        break;
-    }
+static int interpolate_linear( SPC_DSP::voice_t const* v )
+{
+    int const* in = interpolation_input( v );
+    int fract = v->interp_pos & 0xFFF;
+    int out;
 
-    case 4: // sinc filter
-    {
-        int offset = (v->interp_pos & 0xFF0) >> 1;
-        short const* filt = sinc + offset;
-
-        out  = filt [0] * in [0];
-        out += filt [1] * in [1];
-        out += filt [2] * in [2];
-        out += filt [3] * in [3];
-        out += filt [4] * in [4];
-        out += filt [5] * in [5];
-        out += filt [6] * in [6];
-        out += filt [7] * in [7];
-        out >>= 14;
-
-        CLAMP16( out );
-        break;
-    }
+    out  = (0x1000 - fract) * in [0];
+    out +=           fract  * in [1];
+    out >>= 12;
 
-    default:
-    case 2: // Original gaussian filter
-    {
-        // Make pointers into gaussian based on fractional position between samples
-        int offset = v->interp_pos >> 4 & 0xFF;
-        short const* fwd = gauss + 255 - offset;
-        short const* rev = gauss       + offset; // mirror left half of gaussian
+    CLAMP16( out );
+    return out;
+}
 
-        out  = (fwd [  0] * in [0]) >> 11;
-        out += (fwd [256] * in [1]) >> 11;
-        out += (rev [256] * in [2]) >> 11;
-        out = (int16_t) out;
-        out += (rev [  0] * in [3]) >> 11;
+static int interpolate_cubic( SPC_DSP::voice_t const* v )
+{
+    int const* in = interpolation_input( v );
+    short const* taps = cubic_taps [v->interp_pos >> 4 & 0xFF];
+    int out;
 
-        CLAMP16( out );
-        out &= ~1;
+#if SPC_DSP_SSE2
+    // Samples are 16-bit, so packing them is lossless; madd gives two sums
+    __m128i s = _mm_loadu_si128( (__m128i const*) in );
+    __m128i p = _mm_madd_epi16( _mm_packs_epi32( s, s ), _mm_loadl_epi64( (__m128i const*) taps ) );
+    out = _mm_cvtsi128_si32( _mm_add_epi32( p, _mm_srli_si128( p, 4 ) ) );
+#elif SPC_DSP_NEON
+    int32x4_t p = vmull_s16( vmovn_s32( vld1q_s32( in ) ), vld1_s16( taps ) );
+    int32x2_t h = vadd_s32( vget_low_s32( p ), vget_high_s32( p ) );
+    out = vget_lane_s32( vpadd_s32( h, h ), 0 );
+#else
+    out  = taps [0] * in [0];
+    out += taps [1] * in [1];
+    out += taps [2] * in [2];
+    out += taps [3] * in [3];
+#endif
+    out >>= 11;
 
-        break;
-    }
+    CLAMP16( out );
+    return out;
+}
 
-    }
+static int interpolate_sinc( SPC_DSP::voice_t const* v )
+{
+    int const* in = interpolation_input( v );
+    short const* filt = sinc + ((v->interp_pos & 0xFF0) >> 1);
+    int out;
+
+#if SPC_DSP_SSE2
+    __m128i s = _mm_packs_epi32( _mm_loadu_si128( (__m128i const*) in ), _mm_loadu_si128( (__m128i const*) (in + 4) ) );
+    __m128i p = _mm_madd_epi16( s, _mm_loadu_si128( (__m128i const*) filt ) );
+    p = _mm_add_epi32( p, _mm_shuffle_epi32( p, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    p = _mm_add_epi32( p, _mm_shuffle_epi32( p, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    out = _mm_cvtsi128_si32( p );
+#elif SPC_DSP_NEON
+    int16x8_t f = vld1q_s16( filt );
+    int32x4_t p = vmull_s16( vmovn_s32( vld1q_s32( in ) ), vget_low_s16( f ) );
+    p = vmlal_s16( p, vmovn_s32( vld1q_s32( in + 4 ) ), vget_high_s16( f ) );
+    int32x2_t h = vadd_s32( vget_low_s32( p ), vget_high_s32( p ) );
+    out = vget_lane_s32( vpadd_s32( h, h ), 0 );
+#else
+    out  = filt [0] * in [0];
+    out += filt [1] * in [1];
+    out += filt [2] * in [2];
+    out += filt [3] * in [3];
+    out += filt [4] * in [4];
+    out += filt [5] * in [5];
+    out += filt [6] * in [6];
+    out += filt [7] * in [7];
+#endif
+    out >>= 14;
+
+    CLAMP16( out );
+    return out;
+}
+
+// Original gaussian filter. The per-tap shifts and the 16-bit wrap after the
+// third tap are part of the hardware's result, so this one stays scalar.
+static int interpolate_gaussian( SPC_DSP::voice_t const* v )
+{
+    int const* in = interpolation_input( v );
+    short const* taps = gauss_taps [v->interp_pos >> 4 & 0xFF];
+    int out;
+
+    out  = (taps [0] * in [0]) >> 11;
+    out += (taps [1] * in [1]) >> 11;
+    out += (taps [2] * in [2]) >> 11;
+    out = (int16_t) out;
+    out += (taps [3] * in [3]) >> 11;
+
+    CLAMP16( out );
+    out &= ~1;
 
     return out;
 }
 
+void SPC_DSP::set_interpolation( int method )
+{
+    interp_method = method;
+
+    switch ( method )
+    {
+    case 0:  interp_func = interpolate_raw;      break;
+    case 1:  interp_func = interpolate_linear;   break;
+    case 3:  interp_func = interpolate_cubic;    break;
+    case 4:  interp_func = interpolate_sinc;     break;
+    default: interp_func = interpolate_gaussian; break;
+    }
+}
+
 //// Counters
 
 int const simple_counter_range = 2048 * 5 * 3; // 30720
@@ -817,7 +884,7 @@ VOICE_CLOCK( V3c )
 	
 	// Gaussian interpolation
 	{
-		int output = interpolate( v );
+		int output = interp_func( v );
 		
 		// Noise
 		if ( m.t_non & v->vbit )
@@ -1167,6 +1234,9 @@ PHASE(31)  V(V4,0)       V(V1,2)\
 
 void SPC_DSP::run( int clocks_remain )
 {
+	if ( Settings.InterpolationMethod != interp_method )
+		set_interpolation( Settings.InterpolationMethod );
+
 	int const phase = m.phase;
 	m.phase = (phase + clocks_remain) & 31;
 	switch ( phase )
@@ -1189,6 +1259,9 @@ void SPC_DSP::run( int clocks_remain )
 
 void SPC_DSP::init( void* ram_64k )
 {
+	init_interpolation_taps();
+	set_interpolation( Settings.InterpolationMethod );
+
 	m.ram = (uint8_t*) ram_64k;
 	mute_voices( 0 );
 	disable_surround( false );
@@ -65,6 +65,10 @@ public:
 	// Returns non-zero if new key-on events occurred since last call
 	bool check_kon();
 
+	// Selects the voice interpolation kernel (DSP_INTERPOLATION_*). run()
+	// calls this itself when Settings.InterpolationMethod changes.
+	void set_interpolation( int method );
+
 // Snes9x Accessor
 
 	int     stereo_switch;
@@ -203,12 +207,14 @@ private:
 	uint8_t separate_echo_buffer [0x10000];
 	};
 	state_t m;
+
+	int  interp_method;
+	int  (*interp_func)( voice_t const* v );
 	
 	void init_counter();
 	void run_counters();
 	unsigned read_counter( int rate );
 	
-	int  interpolate( voice_t const* v );
 	void run_envelope( voice_t* const v );
 	void decode_brr( voice_t* v );
 
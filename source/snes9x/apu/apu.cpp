@@ -11,16 +11,19 @@
 #include "../snapshot.h"
 #include "../display.h"
 #include "resampler.h"
+#include "../profiler.h"
 
 #define APU_DEFAULT_INPUT_RATE		32040
 #define APU_MINIMUM_SAMPLE_COUNT	512
 #define APU_MINIMUM_SAMPLE_BLOCK	128
+#define APU_SYNC_BATCH_CLOCKS		(APU_MINIMUM_SAMPLE_BLOCK / 2 * 32)	// SPC clocks, 32 per stereo sample
 #define APU_NUMERATOR_NTSC			15664
 #define APU_DENOMINATOR_NTSC		328125
 #define APU_NUMERATOR_PAL			34176
 #define APU_DENOMINATOR_PAL			709379
 
 SNES_SPC	*spc_core = NULL;
+struct SAPUSyncStats	APUSyncStats;
 
 static const uint8 APUROM[64] =
 {
@@ -41,6 +44,8 @@ namespace spc
 
 	static bool8		sound_in_sync   = TRUE;
 	static bool8		sound_enabled   = FALSE;
+	static bool8		sound_discard   = FALSE;	// S9xSetSoundDiscard
+	static SNES_SPC::output_state_t	held_output;	// S9xAPUSaveOutput
 
 	static int			buffer_size;
 	static int			lag_master      = 0;
@@ -53,6 +58,7 @@ namespace spc
 
 	static int32		reference_time;
 	static uint32		remainder;
+	static int32		pending_clocks = 0;	// SPC clocks elapsed before reference_time but not run yet
 
 	static const int	timing_hack_numerator   = SNES_SPC::tempo_unit;
 	static int			timing_hack_denominator = SNES_SPC::tempo_unit;
@@ -216,7 +222,7 @@ void S9xFinalizeSamples (void)
 {
 	bool drop_current_msu1_samples = TRUE;
 
-	if (!Settings.Mute)
+	if (!Settings.Mute && !spc::sound_discard)
 	{
 		drop_current_msu1_samples = FALSE;
 
@@ -247,7 +253,7 @@ void S9xFinalizeSamples (void)
 		}
 	}
 
-	if (!Settings.SoundSync || Settings.TurboMode || Settings.Mute)
+	if (!Settings.SoundSync || Settings.TurboMode || Settings.Mute || spc::sound_discard)
 		spc::sound_in_sync = TRUE;
 	else
 	if (spc::resampler->space_empty() >= spc::resampler->space_filled())
@@ -310,11 +316,15 @@ void UpdatePlaybackRate (void)
 		time_ratio *= spc::dynamic_rate_multiplier;
 	}
 
+	if (spc::resampler->method != Settings.ResamplerMethod)
+		spc::resampler->set_method(Settings.ResamplerMethod);
 	spc::resampler->time_ratio(time_ratio);
 
 	if (Settings.MSU1)
 	{
 		time_ratio = (44100.0 / Settings.SoundPlaybackRate) * (Settings.SoundInputRate / 32040.0);
+		if (msu::resampler->method != Settings.ResamplerMethod)
+			msu::resampler->set_method(Settings.ResamplerMethod);
 		msu::resampler->time_ratio(time_ratio);
 	}
 }
@@ -403,6 +413,28 @@ void S9xSetSoundMute (bool8 mute)
 		Settings.Mute = TRUE;
 }
 
+// While set, samples are generated as usual but thrown away instead of
+// reaching the resampler, e.g. for frames emulated by run-ahead that are
+// going to be rolled back
+void S9xSetSoundDiscard (bool8 discard)
+{
+	spc::sound_discard = discard;
+}
+
+// The samples generated but not handed out yet are not part of a saved
+// state. S9xAPULoadOutput, called after loading a state, puts back the ones
+// S9xAPUSaveOutput found, so the sound carries on from where it was saved.
+void S9xAPUSaveOutput (void)
+{
+	spc_core->save_output(&spc::held_output);
+}
+
+void S9xAPULoadOutput (void)
+{
+	spc_core->load_output(&spc::held_output);
+	spc_core->set_output((SNES_SPC::sample_t *) spc::landing_buffer, spc::buffer_size >> 1);
+}
+
 void S9xDumpSPCSnapshot (void)
 {
 	spc_core->dsp_dump_spc_snapshot();
@@ -492,14 +524,27 @@ static inline int S9xAPUGetClockRemainder (int32 cpucycles)
 			spc::ratio_denominator;
 }
 
+/* The SPC700 is run lazily: the port accesses below run it up to the
+   current CPU time, everything else only when a batch of samples is due,
+   at the start of VBlank, or before its state is looked at. Between runs
+   the elapsed time is carried in spc::pending_clocks. */
+
 uint8 S9xAPUReadPort (int port)
 {
-	return ((uint8) spc_core->read_port(S9xAPUGetClock(CPU.Cycles), port));
+	PROFILE_ENTER(PROF_APU);
+	APUSyncStats.PortAccesses++;
+	uint8	byte = (uint8) spc_core->read_port(spc::pending_clocks + S9xAPUGetClock(CPU.Cycles), port);
+	PROFILE_LEAVE();
+
+	return (byte);
 }
 
 void S9xAPUWritePort (int port, uint8 byte)
 {
-	spc_core->write_port(S9xAPUGetClock(CPU.Cycles), port, byte);
+	PROFILE_ENTER(PROF_APU);
+	APUSyncStats.PortAccesses++;
+	spc_core->write_port(spc::pending_clocks + S9xAPUGetClock(CPU.Cycles), port, byte);
+	PROFILE_LEAVE();
 }
 
 void S9xAPUSetReferenceTime (int32 cpucycles)
@@ -507,22 +552,54 @@ void S9xAPUSetReferenceTime (int32 cpucycles)
 	spc::reference_time = cpucycles;
 }
 
-void S9xAPUExecute (void)
+static void S9xAPUAccumulate (void)
 {
 	/* Accumulate partial APU cycles */
-	spc_core->end_frame(S9xAPUGetClock(CPU.Cycles));
+	spc::pending_clocks += S9xAPUGetClock(CPU.Cycles);
 
 	spc::remainder = S9xAPUGetClockRemainder(CPU.Cycles);
 
 	S9xAPUSetReferenceTime(CPU.Cycles);
 }
 
+static void S9xAPURunPending (void)
+{
+	if (spc::pending_clocks)
+	{
+		spc_core->end_frame(spc::pending_clocks);
+
+		APUSyncStats.Batches++;
+		APUSyncStats.Clocks += spc::pending_clocks;
+		spc::pending_clocks = 0;
+	}
+}
+
+void S9xAPUExecute (void)
+{
+	S9xAPUAccumulate();
+	S9xAPURunPending();
+}
+
 void S9xAPUEndScanline (void)
 {
-	S9xAPUExecute();
+	S9xAPUAccumulate();
+
+	if (spc::pending_clocks < APU_SYNC_BATCH_CLOCKS && spc::sound_in_sync)
+		return;
+
+	S9xAPUSync();
+}
+
+void S9xAPUSync (void)
+{
+	PROFILE_ENTER(PROF_APU);
+
+	S9xAPURunPending();
 
 	if (spc_core->sample_count() >= APU_MINIMUM_SAMPLE_BLOCK || !spc::sound_in_sync)
 		S9xLandSamples();
+
+	PROFILE_LEAVE();
 }
 
 void S9xAPUTimingSetSpeedup (int ticks)
@@ -549,6 +626,7 @@ void S9xResetAPU (void)
 {
 	spc::reference_time = 0;
 	spc::remainder = 0;
+	spc::pending_clocks = 0;
 	spc_core->reset();
 	spc_core->set_output((SNES_SPC::sample_t *) spc::landing_buffer, spc::buffer_size >> 1);
 
@@ -562,6 +640,7 @@ void S9xSoftResetAPU (void)
 {
 	spc::reference_time = 0;
 	spc::remainder = 0;
+	spc::pending_clocks = 0;
 	spc_core->soft_reset();
 	spc_core->set_output((SNES_SPC::sample_t *) spc::landing_buffer, spc::buffer_size >> 1);
 
@@ -587,6 +666,7 @@ void S9xAPUSaveState (uint8 *block)
 {
 	uint8	*ptr = block;
 
+	S9xAPURunPending();
 	spc_core->copy_state(&ptr, from_apu_to_state);
 
 	SET_LE32(ptr, spc::reference_time);
@@ -594,12 +674,10 @@ void S9xAPUSaveState (uint8 *block)
 	SET_LE32(ptr, spc::remainder);
 }
 
-void S9xAPULoadState (uint8 *block)
+static void S9xAPUCopyStateIn (uint8 *block)
 {
 	uint8	*ptr = block;
 
-	S9xResetAPU();
-
 	spc_core->copy_state(&ptr, to_apu_from_state);
 
 	spc::reference_time = GET_LE32(ptr);
@@ -607,6 +685,25 @@ void S9xAPULoadState (uint8 *block)
 	spc::remainder = GET_LE32(ptr);
 }
 
+void S9xAPULoadState (uint8 *block)
+{
+	S9xResetAPU();
+	S9xAPUCopyStateIn(block);
+}
+
+// Like S9xAPULoadState, but the samples already in the resamplers are kept,
+// so whatever was mixed before the state was saved still gets played
+void S9xAPURestoreState (uint8 *block)
+{
+	spc::reference_time = 0;
+	spc::remainder = 0;
+	spc::pending_clocks = 0;
+	spc_core->reset();
+	spc_core->set_output((SNES_SPC::sample_t *) spc::landing_buffer, spc::buffer_size >> 1);
+
+	S9xAPUCopyStateIn(block);
+}
+
 bool8 S9xSPCDump (const char *filename)
 {
 	FILE	*fs;
@@ -619,6 +716,7 @@ bool8 S9xSPCDump (const char *filename)
 
 	S9xSetSoundMute(TRUE);
 
+	S9xAPURunPending();
 	spc_core->init_header(buf);
 	spc_core->save_spc(buf);
 
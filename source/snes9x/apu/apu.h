@@ -12,6 +12,13 @@
 
 typedef void (*apu_callback) (void *);
 
+struct SAPUSyncStats
+{
+	uint32	Batches;		// SNES_SPC::end_frame() calls
+	uint32	PortAccesses;	// $2140-$2143 reads and writes, each runs the SPC700 up to date
+	uint64	Clocks;			// SPC clocks run in batches
+};
+
 #define SPC_SAVE_STATE_BLOCK_SIZE	(SNES_SPC::state_size + 8)
 
 bool8 S9xInitAPU (void);
@@ -22,11 +29,15 @@ uint8 S9xAPUReadPort (int);
 void S9xAPUWritePort (int, uint8);
 void S9xAPUExecute (void);
 void S9xAPUEndScanline (void);
+void S9xAPUSync (void);
 void S9xAPUSetReferenceTime (int32);
 void S9xAPUTimingSetSpeedup (int);
 void S9xAPUAllowTimeOverflow (bool);
 void S9xAPULoadState (uint8 *);
 void S9xAPUSaveState (uint8 *);
+void S9xAPURestoreState (uint8 *);
+void S9xAPUSaveOutput (void);
+void S9xAPULoadOutput (void);
 void S9xDumpSPCSnapshot (void);
 bool8 S9xSPCDump (const char *);
 
@@ -37,6 +48,7 @@ bool8 S9xSyncSound (void);
 int S9xGetSampleCount (void);
 void S9xSetSoundControl (uint8);
 void S9xSetSoundMute (bool8);
+void S9xSetSoundDiscard (bool8);
 void S9xLandSamples (void);
 void S9xFinalizeSamples (void);
 void S9xClearSamples (void);
@@ -44,7 +56,8 @@ bool8 S9xMixSamples (uint8 *, int);
 void S9xSetSamplesAvailableCallback (apu_callback, void *);
 void S9xUpdateDynamicRate (double rate);
 
-extern SNES_SPC	*spc_core;
+extern SNES_SPC				*spc_core;
+extern struct SAPUSyncStats	APUSyncStats;
 
 #define DSP_INTERPOLATION_NONE     0
 #define DSP_INTERPOLATION_LINEAR   1
@@ -15,6 +15,17 @@
 #include <stdint.h>
 #endif
 #include <cmath>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define RESAMPLER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_NEON 1
+#endif
+
+// Resampler::method values
+#define RESAMPLER_HERMITE	0	// 4-point Hermite spline
+#define RESAMPLER_SINC		1	// 32-tap Kaiser-windowed sinc, polyphase
 
 class Resampler
 {
@@ -28,6 +39,19 @@ class Resampler
     float r_frac;
     int   r_left[4], r_right[4];
 
+    // Windowed sinc. Row p of sinc_table holds the taps for an output
+    // position p / sinc_phases of the way from the middle input frame to the
+    // next one; positions in between interpolate two rows. The history is
+    // kept per channel and written twice so the taps always see one
+    // contiguous window, oldest frame first.
+    enum { sinc_taps = 32, sinc_phases = 256 };
+
+    int   method;
+    float *sinc_table;
+    float sinc_cutoff;
+    float hist[2][sinc_taps * 2];
+    int   hist_pos;
+
     static inline int16_t short_clamp(int n)
     {
         return (int16_t)(((int16_t)n != n) ? (n >> 31) ^ 0x7fff : n);
@@ -56,11 +80,62 @@ class Resampler
         return (a0 * b) + (a1 * m0) + (a2 * m1) + (a3 * c);
     }
 
+    static double bessel_i0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (x / (2 * k)) * (x / (2 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // cutoff is relative to the input Nyquist frequency
+    void build_sinc_table(float cutoff)
+    {
+        const double beta = 7.0;
+        const double pi = 3.14159265358979323846;
+
+        if (!sinc_table)
+            sinc_table = new float[(sinc_phases + 2) * sinc_taps];
+
+        for (int p = 0; p <= sinc_phases + 1; p++)
+        {
+            float *row = sinc_table + p * sinc_taps;
+            double sum = 0.0;
+
+            for (int k = 0; k < sinc_taps; k++)
+            {
+                double x = k - (sinc_taps / 2 - 1) - (double) p / sinc_phases;
+                double w = x / (sinc_taps / 2);
+                double h = cutoff;
+
+                if (x != 0.0)
+                    h = sin(pi * cutoff * x) / (pi * x);
+
+                h *= (w < 1.0 && w > -1.0) ? bessel_i0(beta * sqrt(1.0 - w * w)) / bessel_i0(beta) : 0.0;
+                row[k] = (float) h;
+                sum += h;
+            }
+
+            for (int k = 0; k < sinc_taps; k++)
+                row[k] = (float) (row[k] / sum);
+        }
+
+        sinc_cutoff = cutoff;
+    }
+
     Resampler()
     {
         this->buffer_size = 0;
         buffer = NULL;
         r_step = 1.0;
+        method = RESAMPLER_HERMITE;
+        sinc_table = NULL;
+        sinc_cutoff = 0.0;
     }
 
     Resampler(int num_samples)
@@ -68,6 +143,9 @@ class Resampler
         this->buffer_size = num_samples;
         buffer = new int16_t[this->buffer_size];
         r_step = 1.0;
+        method = RESAMPLER_HERMITE;
+        sinc_table = NULL;
+        sinc_cutoff = 0.0;
         clear();
     }
 
@@ -75,11 +153,30 @@ class Resampler
     {
         delete[] buffer;
         buffer = NULL;
+        delete[] sinc_table;
+        sinc_table = NULL;
+    }
+
+    inline void set_method(int m)
+    {
+        method = m;
+        time_ratio(r_step);
     }
 
     inline void time_ratio(double ratio)
     {
         r_step = ratio;
+
+        if (method == RESAMPLER_SINC)
+        {
+            // Leave some room below the lower of the two Nyquist rates.
+            // Dynamic rate control only nudges the ratio, so the table is
+            // only rebuilt when the rates themselves change.
+            float cutoff = 0.85f * (ratio > 1.0 ? 1.0 / ratio : 1.0);
+
+            if (!sinc_table || fabsf(cutoff - sinc_cutoff) > 0.02f * sinc_cutoff)
+                build_sinc_table(cutoff);
+        }
     }
 
     inline void clear(void)
@@ -94,6 +191,9 @@ class Resampler
         r_frac = 0.0;
         r_left[0] = r_left[1] = r_left[2] = r_left[3] = 0;
         r_right[0] = r_right[1] = r_right[2] = r_right[3] = 0;
+
+        memset(hist, 0, sizeof(hist));
+        hist_pos = 0;
     }
 
     inline bool pull(int16_t *dst, int num_samples)
@@ -145,6 +245,97 @@ class Resampler
         return true;
     }
 
+    // One stereo output frame from the history window at fractional position
+    // frac, with the taps interpolated between the two neighbouring phases
+    inline void sinc_frame(float frac, int16_t *out)
+    {
+        float        pos = frac * sinc_phases;
+        int          p = (int) pos;
+        float        mix = pos - p;
+        const float *c0 = sinc_table + p * sinc_taps;
+        const float *c1 = c0 + sinc_taps;
+        const float *l = hist[0] + hist_pos;
+        const float *r = hist[1] + hist_pos;
+        float        sum_l, sum_r;
+
+#if RESAMPLER_SSE
+        __m128 m = _mm_set1_ps(mix);
+        __m128 acc_l = _mm_setzero_ps(), acc_r = _mm_setzero_ps();
+
+        for (int k = 0; k < sinc_taps; k += 4)
+        {
+            __m128 a = _mm_loadu_ps(c0 + k);
+            __m128 c = _mm_add_ps(a, _mm_mul_ps(m, _mm_sub_ps(_mm_loadu_ps(c1 + k), a)));
+            acc_l = _mm_add_ps(acc_l, _mm_mul_ps(_mm_loadu_ps(l + k), c));
+            acc_r = _mm_add_ps(acc_r, _mm_mul_ps(_mm_loadu_ps(r + k), c));
+        }
+
+        // (l0+l2, r0+r2, l1+l3, r1+r3) then fold the halves
+        __m128 t = _mm_add_ps(_mm_unpacklo_ps(acc_l, acc_r), _mm_unpackhi_ps(acc_l, acc_r));
+        t = _mm_add_ps(t, _mm_movehl_ps(t, t));
+        sum_l = _mm_cvtss_f32(t);
+        sum_r = _mm_cvtss_f32(_mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1)));
+#elif RESAMPLER_NEON
+        float32x4_t acc_l = vdupq_n_f32(0.0f), acc_r = vdupq_n_f32(0.0f);
+
+        for (int k = 0; k < sinc_taps; k += 4)
+        {
+            float32x4_t a = vld1q_f32(c0 + k);
+            float32x4_t c = vmlaq_n_f32(a, vsubq_f32(vld1q_f32(c1 + k), a), mix);
+            acc_l = vmlaq_f32(acc_l, vld1q_f32(l + k), c);
+            acc_r = vmlaq_f32(acc_r, vld1q_f32(r + k), c);
+        }
+
+        float32x2_t h_l = vadd_f32(vget_low_f32(acc_l), vget_high_f32(acc_l));
+        float32x2_t h_r = vadd_f32(vget_low_f32(acc_r), vget_high_f32(acc_r));
+        sum_l = vget_lane_f32(vpadd_f32(h_l, h_l), 0);
+        sum_r = vget_lane_f32(vpadd_f32(h_r, h_r), 0);
+#else
+        sum_l = sum_r = 0.0f;
+
+        for (int k = 0; k < sinc_taps; k++)
+        {
+            float c = c0[k] + mix * (c1[k] - c0[k]);
+            sum_l += l[k] * c;
+            sum_r += r[k] * c;
+        }
+#endif
+
+        out[0] = short_clamp((int) sum_l);
+        out[1] = short_clamp((int) sum_r);
+    }
+
+    // Same stepping as the Hermite loop in read(), so avail() holds for both
+    void read_sinc(int16_t *data, int num_samples)
+    {
+        int o_position = 0;
+
+        while (o_position < num_samples && size > 0)
+        {
+            while (r_frac <= 1.0 && o_position < num_samples)
+            {
+                sinc_frame(r_frac, data + o_position);
+                o_position += 2;
+                r_frac += r_step;
+            }
+
+            while (r_frac > 1.0 && size > 0)
+            {
+                hist[0][hist_pos] = hist[0][hist_pos + sinc_taps] = buffer[start];
+                hist[1][hist_pos] = hist[1][hist_pos + sinc_taps] = buffer[start + 1];
+                if (++hist_pos == sinc_taps)
+                    hist_pos = 0;
+
+                r_frac -= 1.0;
+
+                start += 2;
+                if (start >= buffer_size)
+                    start -= buffer_size;
+                size -= 2;
+            }
+        }
+    }
+
     void read(int16_t *data, int num_samples)
     {
         //If we are outputting the exact same ratio as the input, pull directly from the input buffer
@@ -155,6 +346,13 @@ class Resampler
         }
 
         assert((num_samples & 1) == 0); // resampler always processes both stereo samples
+
+        if (method == RESAMPLER_SINC)
+        {
+            read_sinc(data, num_samples);
+            return;
+        }
+
         int o_position = 0;
 
         while (o_position < num_samples && size > 0)
@@ -8,6 +8,8 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "cpuexec.h"
+#include "fxemu.h"
 #include "cheats.h"
 #include "bml.h"
 
@@ -116,6 +118,11 @@ static inline void S9xSetByteFree (uint8 Byte, uint32 Address)
     if (SetAddress >= (uint8 *) CMemory::MAP_LAST)
     {
         *(SetAddress + (Address & 0xffff)) = Byte;
+        if (Memory.BlockIsROM[block])
+        {
+            S9xBlockCacheFlush();
+            fx_flushBlockCache();
+        }
         return;
     }
 
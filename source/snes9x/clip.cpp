@@ -6,6 +6,24 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "profiler.h"
+
+// Compiled clip windows of recent window setups, so HDMA effects that cycle
+// through the same setups every frame don't rebuild the regions on each
+// change. The key holds everything ComputeClipWindows reads; entries are
+// hashed into small sets with LRU replacement inside each set.
+#define CLIP_CACHE_SETS	32
+#define CLIP_CACHE_WAYS	4
+
+struct SClipCacheEntry
+{
+	uint32			Key[3];
+	uint32			Used;		// LRU stamp, 0 for an empty entry
+	struct ClipData	Clip[2][6];
+};
+
+static struct SClipCacheEntry	ClipCache[CLIP_CACHE_SETS][CLIP_CACHE_WAYS];
+static uint32					ClipCacheStamp = 0;
 
 static uint8	region_map[6][6] =
 {
@@ -99,7 +117,7 @@ static inline void StoreWindowRegions (uint8 Mask, struct ClipData *Clip, int n_
 	Clip->Count = ct;
 }
 
-void S9xComputeClipWindows (void)
+static void ComputeClipWindows (void)
 {
 	int16	windows[6] = { 0, 256, 256, 256, 256, 256 };
 	uint8	drawing_modes[5] = { 0, 0, 0, 0, 0 };
@@ -232,3 +250,51 @@ void S9xComputeClipWindows (void)
 		}
 	}
 }
+
+static inline void ClipCacheKey (uint32 *key)
+{
+	uint32	layers[6];
+
+	for (int i = 0; i < 6; i++)
+		layers[i] = (PPU.ClipWindow1Enable[i] & 1) | ((PPU.ClipWindow2Enable[i] & 1) << 1) |
+					((PPU.ClipWindow1Inside[i] & 1) << 2) | ((PPU.ClipWindow2Inside[i] & 1) << 3) | ((PPU.ClipWindowOverlapLogic[i] & 3) << 4);
+
+	key[0] = PPU.Window1Left | (PPU.Window1Right << 8) | (PPU.Window2Left << 16) | (PPU.Window2Right << 24);
+	key[1] = layers[0] | (layers[1] << 6) | (layers[2] << 12) | (layers[3] << 18) | (layers[4] << 24);
+	key[2] = layers[5] | ((Memory.FillRAM[0x2130] & 0xf0) << 2) | ((Memory.FillRAM[0x212e] & 0x1f) << 12) |
+			 ((Memory.FillRAM[0x212f] & 0x1f) << 17) | ((Settings.DisableGraphicWindows ? 1 : 0) << 22);
+}
+
+void S9xComputeClipWindows (void)
+{
+	uint32	key[3];
+
+	ClipCacheKey(key);
+
+	uint32					hash = (key[0] * 0x9e3779b1) ^ (key[1] * 0x85ebca77) ^ (key[2] * 0xc2b2ae3d);
+	uint32					set = (hash >> 16) & (CLIP_CACHE_SETS - 1);
+	struct SClipCacheEntry	*victim = &ClipCache[set][0];
+
+	for (int e = 0; e < CLIP_CACHE_WAYS; e++)
+	{
+		struct SClipCacheEntry	*c = &ClipCache[set][e];
+
+		if (c->Used && c->Key[0] == key[0] && c->Key[1] == key[1] && c->Key[2] == key[2])
+		{
+			c->Used = ++ClipCacheStamp;
+			memcpy(IPPU.Clip, c->Clip, sizeof(IPPU.Clip));
+			PROFILE_CLIP_HIT();
+			return;
+		}
+
+		if (c->Used < victim->Used)
+			victim = c;
+	}
+
+	ComputeClipWindows();
+	PROFILE_CLIP_MISS();
+
+	memcpy(victim->Key, key, sizeof(victim->Key));
+	memcpy(victim->Clip, IPPU.Clip, sizeof(victim->Clip));
+	victim->Used = ++ClipCacheStamp;
+}
@@ -13,6 +13,8 @@
 #include "srtc.h"
 #include "snapshot.h"
 #include "cheats.h"
+#include "profiler.h"
+#include "opstats.h"
 #ifdef DEBUGGER
 #include "debug.h"
 #endif
@@ -98,6 +100,9 @@ static void S9xSoftResetCPU (void)
 void S9xReset (void)
 {
 	S9xResetSaveTimer(FALSE);
+	PROFILE_RESET();
+	OPSTATS_RESET();
+	S9xBlockCacheFlush();
 
 	memset(Memory.RAM, 0x55, 0x20000);
 	memset(Memory.VRAM, 0x00, 0x10000);
@@ -135,6 +140,9 @@ void S9xReset (void)
 void S9xSoftReset (void)
 {
 	S9xResetSaveTimer(FALSE);
+	PROFILE_RESET();
+	OPSTATS_RESET();
+	S9xBlockCacheFlush();
 
 	memset(Memory.FillRAM, 0, 0x8000);
 
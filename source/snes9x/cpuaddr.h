@@ -40,7 +40,7 @@ static inline uint8 Immediate8 (AccessMode a)
 
 static inline uint16 Immediate16Slow (AccessMode a)
 {
-	uint16	val = S9xGetWord(Registers.PBPC, WRAP_BANK);
+	uint16	val = S9xGetWord<WRAP_BANK>(Registers.PBPC);
 	if (a & READ)
 		OpenBus = (uint8) (val >> 8);
 	Registers.PCw += 2;
@@ -107,7 +107,7 @@ static inline uint32 AbsoluteIndexedIndirectSlow (AccessMode a)			// (a,X)
 	addr += Registers.X.W;
 
 	// Address load wraps within the bank
-	uint16	addr2 = S9xGetWord(ICPU.ShiftedPB | addr, WRAP_BANK);
+	uint16	addr2 = S9xGetWord<WRAP_BANK>(ICPU.ShiftedPB | addr);
 	OpenBus = addr2 >> 8;
 
 	return (addr2);
@@ -121,7 +121,7 @@ static inline uint32 AbsoluteIndexedIndirect (AccessMode a)				// (a,X)
 	addr += Registers.X.W;
 
 	// Address load wraps within the bank
-	uint16	addr2 = S9xGetWord(ICPU.ShiftedPB | addr, WRAP_BANK);
+	uint16	addr2 = S9xGetWord<WRAP_BANK>(ICPU.ShiftedPB | addr);
 	OpenBus = addr2 >> 8;
 
 	return (addr2);
@@ -132,7 +132,7 @@ static inline uint32 AbsoluteIndirectLongSlow (AccessMode a)			// [a]
 	uint16	addr = Immediate16Slow(READ);
 
 	// No info on wrapping, but it doesn't matter anyway due to mirroring
-	uint32	addr2 = S9xGetWord(addr);
+	uint32	addr2 = S9xGetWord<WRAP_NONE>(addr);
 	OpenBus = addr2 >> 8;
 	addr2 |= (OpenBus = S9xGetByte(addr + 2)) << 16;
 
@@ -144,7 +144,7 @@ static inline uint32 AbsoluteIndirectLong (AccessMode a)				// [a]
 	uint16	addr = Immediate16(READ);
 
 	// No info on wrapping, but it doesn't matter anyway due to mirroring
-	uint32	addr2 = S9xGetWord(addr);
+	uint32	addr2 = S9xGetWord<WRAP_NONE>(addr);
 	OpenBus = addr2 >> 8;
 	addr2 |= (OpenBus = S9xGetByte(addr + 2)) << 16;
 
@@ -154,7 +154,7 @@ static inline uint32 AbsoluteIndirectLong (AccessMode a)				// [a]
 static inline uint32 AbsoluteIndirectSlow (AccessMode a)				// (a)
 {
 	// No info on wrapping, but it doesn't matter anyway due to mirroring
-	uint16	addr2 = S9xGetWord(Immediate16Slow(READ));
+	uint16	addr2 = S9xGetWord<WRAP_NONE>(Immediate16Slow(READ));
 	OpenBus = addr2 >> 8;
 
 	return (addr2);
@@ -163,7 +163,7 @@ static inline uint32 AbsoluteIndirectSlow (AccessMode a)				// (a)
 static inline uint32 AbsoluteIndirect (AccessMode a)					// (a)
 {
 	// No info on wrapping, but it doesn't matter anyway due to mirroring
-	uint16	addr2 = S9xGetWord(Immediate16(READ));
+	uint16	addr2 = S9xGetWord<WRAP_NONE>(Immediate16(READ));
 	OpenBus = addr2 >> 8;
 
 	return (addr2);
@@ -234,7 +234,7 @@ static inline uint32 DirectIndirectSlow (AccessMode a)					// (d)
 
 static inline uint32 DirectIndirectE0 (AccessMode a)					// (d)
 {
-	uint32	addr = S9xGetWord(Direct(READ));
+	uint32	addr = S9xGetWord<WRAP_NONE>(Direct(READ));
 	if (a & READ)
 		OpenBus = (uint8) (addr >> 8);
 	addr |= ICPU.ShiftedDB;
@@ -290,7 +290,7 @@ static inline uint32 DirectIndirectIndexedE1 (AccessMode a)				// (d),Y
 static inline uint32 DirectIndirectLongSlow (AccessMode a)				// [d]
 {
 	uint16	addr = DirectSlow(READ);
-	uint32	addr2 = S9xGetWord(addr);
+	uint32	addr2 = S9xGetWord<WRAP_NONE>(addr);
 	OpenBus = addr2 >> 8;
 	addr2 |= (OpenBus = S9xGetByte(addr + 2)) << 16;
 
@@ -300,7 +300,7 @@ static inline uint32 DirectIndirectLongSlow (AccessMode a)				// [d]
 static inline uint32 DirectIndirectLong (AccessMode a)					// [d]
 {
 	uint16	addr = Direct(READ);
-	uint32	addr2 = S9xGetWord(addr);
+	uint32	addr2 = S9xGetWord<WRAP_NONE>(addr);
 	OpenBus = addr2 >> 8;
 	addr2 |= (OpenBus = S9xGetByte(addr + 2)) << 16;
 
@@ -402,7 +402,7 @@ static inline uint32 DirectIndexedIndirectSlow (AccessMode a)			// (d,X)
 
 static inline uint32 DirectIndexedIndirectE0 (AccessMode a)				// (d,X)
 {
-	uint32	addr = S9xGetWord(DirectIndexedXE0(READ));
+	uint32	addr = S9xGetWord<WRAP_NONE>(DirectIndexedXE0(READ));
 	if (a & READ)
 		OpenBus = (uint8) (addr >> 8);
 
@@ -498,7 +498,7 @@ static inline uint32 StackRelative (AccessMode a)						// d,S
 
 static inline uint32 StackRelativeIndirectIndexedSlow (AccessMode a)	// (d,S),Y
 {
-	uint32	addr = S9xGetWord(StackRelativeSlow(READ));
+	uint32	addr = S9xGetWord<WRAP_NONE>(StackRelativeSlow(READ));
 	if (a & READ)
 		OpenBus = (uint8) (addr >> 8);
 	addr = (addr + Registers.Y.W + ICPU.ShiftedDB) & 0xffffff;
@@ -509,7 +509,7 @@ static inline uint32 StackRelativeIndirectIndexedSlow (AccessMode a)	// (d,S),Y
 
 static inline uint32 StackRelativeIndirectIndexed (AccessMode a)		// (d,S),Y
 {
-	uint32	addr = S9xGetWord(StackRelative(READ));
+	uint32	addr = S9xGetWord<WRAP_NONE>(StackRelative(READ));
 	if (a & READ)
 		OpenBus = (uint8) (addr >> 8);
 	addr = (addr + Registers.Y.W + ICPU.ShiftedDB) & 0xffffff;
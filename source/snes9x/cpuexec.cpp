@@ -11,7 +11,10 @@
 #include "apu/apu.h"
 #include "fxemu.h"
 #include "snapshot.h"
+#include "runahead.h"
 #include "movie.h"
+#include "profiler.h"
+#include "opstats.h"
 #ifdef DEBUGGER
 #include "debug.h"
 #include "missing.h"
@@ -19,6 +22,142 @@
 
 static inline void S9xReschedule (void);
 
+#ifdef CPU_BLOCK_CACHE
+
+#define BLOCK_CACHE_SIZE	2048	// entries, must be a power of two
+#define BLOCK_MAX_OPS		16
+
+// A run of straight-line instructions starting at Address, decoded with the
+// opcode table (M/X/E state) that was current when it was first reached
+struct SCachedBlock
+{
+	uint32			Address;				// PB:PC of the first opcode
+	struct SOpcodes	*Table;
+	uint8			*Code;					// CPU.PCBase + PCw of the first opcode
+	uint32			Count;					// 0 = can't be run from the cache
+	uint32			OpAddress[BLOCK_MAX_OPS];
+	uint8			Op[BLOCK_MAX_OPS];
+	void			(*Handler[BLOCK_MAX_OPS]) (void);
+};
+
+static struct SCachedBlock	BlockCache[BLOCK_CACHE_SIZE];
+
+void S9xBlockCacheFlush (void)
+{
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++)
+		BlockCache[i].Address = 0xffffffff;
+}
+
+// Branches, jumps, calls, returns, interrupts, WAI/STP, block moves and
+// everything that can switch the M/X/E opcode table end a block
+static bool8 S9xEndsBlock (uint8 Op)
+{
+	switch (Op)
+	{
+		case 0x10: case 0x30: case 0x50: case 0x70:
+		case 0x90: case 0xb0: case 0xd0: case 0xf0:
+		case 0x80: case 0x82:
+		case 0x4c: case 0x5c: case 0x6c: case 0x7c: case 0xdc:
+		case 0x20: case 0x22: case 0xfc:
+		case 0x60: case 0x6b: case 0x40:
+		case 0x00: case 0x02: case 0x42:
+		case 0xcb: case 0xdb:
+		case 0x44: case 0x54:
+		case 0xc2: case 0xe2: case 0xfb: case 0x28:
+			return (TRUE);
+
+		default:
+			return (FALSE);
+	}
+}
+
+// Only ROM blocks that can't be written through WriteMap are cached, so
+// nothing on the store path has to invalidate entries. BS-X flash is left
+// out as it's remapped and rewritten behind the memory map's back.
+static void S9xCompileBlock (struct SCachedBlock *Block)
+{
+	uint16	Offset = Registers.PCw;
+	uint32	block = Registers.PBPC >> MEMMAP_SHIFT;
+
+	Block->Address = Registers.PBPC;
+	Block->Table = ICPU.S9xOpcodes;
+	Block->Code = CPU.PCBase + Offset;
+	Block->Count = 0;
+
+	if (!Memory.BlockIsROM[block] || Memory.WriteMap[block] >= (uint8 *) CMemory::MAP_LAST || Settings.BS)
+		return;
+
+	while (Block->Count < BLOCK_MAX_OPS)
+	{
+		uint8	Op = CPU.PCBase[Offset];
+
+		// Same test as S9xMainLoop: instructions touching the end of the
+		// memory block are left to the uncached path
+		if ((Offset & MEMMAP_MASK) + ICPU.S9xOpLengths[Op] >= MEMMAP_BLOCK_SIZE)
+			break;
+
+		Block->OpAddress[Block->Count] = ICPU.ShiftedPB + Offset;
+		Block->Op[Block->Count] = Op;
+		Block->Handler[Block->Count] = ICPU.S9xOpcodes[Op].S9xOpcode;
+		Block->Count++;
+
+		if (S9xEndsBlock(Op))
+			break;
+
+		Offset += ICPU.S9xOpLengths[Op];
+	}
+}
+
+// Runs the cached block at PBPC, if there is one. The cache is flushed on
+// reset and when cheats patch ROM. Each instruction does exactly what the
+// fast path in S9xMainLoop would do. After each one the block is left as soon
+// as control flow leaves it or the top of S9xMainLoop would have anything to
+// do (NMI, IRQ, IRQ flag change, end of frame), so interrupt timing is
+// unchanged.
+static bool8 S9xRunCachedBlock (void)
+{
+	struct SCachedBlock	*Block = &BlockCache[(Registers.PBPC ^ (Registers.PBPC >> 11)) & (BLOCK_CACHE_SIZE - 1)];
+	uint8				*PCBase = CPU.PCBase;
+
+	if (Block->Address != Registers.PBPC || Block->Table != ICPU.S9xOpcodes || Block->Code != PCBase + Registers.PCw)
+		S9xCompileBlock(Block);
+
+	if (!Block->Count)
+		return (FALSE);
+
+	for (uint32 i = 0;;)
+	{
+		CPU.Cycles += CPU.MemSpeed;
+		OPSTATS_RECORD(Block->Op[i], Registers.PBPC, FALSE);
+		Registers.PCw++;
+		PROFILE_OPCODE();
+		(*Block->Handler[i])();
+
+		if (Settings.SA1)
+		{
+			PROFILE_ENTER(PROF_SA1);
+			S9xSA1MainLoop();
+			PROFILE_LEAVE();
+		}
+
+		if (++i == Block->Count || Registers.PBPC != Block->OpAddress[i] || CPU.PCBase != PCBase)
+			break;
+
+		if (CPU.Cycles >= CPU.InterruptHorizon)
+			break;
+	}
+
+	return (TRUE);
+}
+
+#else
+
+void S9xBlockCacheFlush (void)
+{
+}
+
+#endif
+
 void S9xMainLoop (void)
 {
 	#define CHECK_FOR_IRQ_CHANGE() \
@@ -36,24 +175,57 @@ void S9xMainLoop (void)
 		Timings.IRQFlagChanging = IRQ_NONE; \
 	}
 
+	PROFILE_ENTER(PROF_CPU);
+
 	if (CPU.Flags & SCAN_KEYS_FLAG)
 	{
 		CPU.Flags &= ~SCAN_KEYS_FLAG;
 		S9xMovieUpdate();
 	}
 
+	// The frontend may have reset or loaded a snapshot since the last frame
+	S9xUpdateInterruptHorizon();
+
 	for (;;)
 	{
-		if (CPU.NMIPending)
+		if (CPU.Cycles >= CPU.InterruptHorizon)
 		{
-			#ifdef DEBUGGER
-			if (Settings.TraceHCEvent)
-			    S9xTraceFormattedMessage ("Comparing %d to %d\n", Timings.NMITriggerPos, CPU.Cycles);
-			#endif
-			if (Timings.NMITriggerPos <= CPU.Cycles)
+			if (CPU.NMIPending)
+			{
+				#ifdef DEBUGGER
+				if (Settings.TraceHCEvent)
+				    S9xTraceFormattedMessage ("Comparing %d to %d\n", Timings.NMITriggerPos, CPU.Cycles);
+				#endif
+				if (Timings.NMITriggerPos <= CPU.Cycles)
+				{
+					CPU.NMIPending = FALSE;
+					Timings.NMITriggerPos = 0xffff;
+					if (CPU.WaitingForInterrupt)
+					{
+						CPU.WaitingForInterrupt = FALSE;
+						Registers.PCw++;
+						CPU.Cycles += TWO_CYCLES + ONE_DOT_CYCLE / 2;
+						while (CPU.Cycles >= CPU.NextEvent)
+							S9xDoHEventProcessing();
+					}
+
+					CHECK_FOR_IRQ_CHANGE();
+					S9xOpcode_NMI();
+				}
+			}
+
+			if (CPU.Cycles >= Timings.NextIRQTimer)
+			{
+				#ifdef DEBUGGER
+				S9xTraceMessage ("Timer triggered\n");
+				#endif
+
+				S9xUpdateIRQPositions(false);
+				CPU.IRQLine = TRUE;
+			}
+
+			if (CPU.IRQLine || CPU.IRQExternal)
 			{
-				CPU.NMIPending = FALSE;
-				Timings.NMITriggerPos = 0xffff;
 				if (CPU.WaitingForInterrupt)
 				{
 					CPU.WaitingForInterrupt = FALSE;
@@ -63,85 +235,70 @@ void S9xMainLoop (void)
 						S9xDoHEventProcessing();
 				}
 
-				CHECK_FOR_IRQ_CHANGE();
-				S9xOpcode_NMI();
+				if (!CheckFlag(IRQ))
+				{
+					/* The flag pushed onto the stack is the new value */
+					CHECK_FOR_IRQ_CHANGE();
+					S9xOpcode_IRQ();
+				}
 			}
-		}
 
-		if (CPU.Cycles >= Timings.NextIRQTimer)
-		{
-			#ifdef DEBUGGER
-			S9xTraceMessage ("Timer triggered\n");
-			#endif
+			/* Change IRQ flag for instructions that set it only on last cycle */
+			CHECK_FOR_IRQ_CHANGE();
 
-			S9xUpdateIRQPositions(false);
-			CPU.IRQLine = TRUE;
-		}
-
-		if (CPU.IRQLine || CPU.IRQExternal)
-		{
-			if (CPU.WaitingForInterrupt)
+		#ifdef DEBUGGER
+			if ((CPU.Flags & BREAK_FLAG) && !(CPU.Flags & SINGLE_STEP_FLAG))
 			{
-				CPU.WaitingForInterrupt = FALSE;
-				Registers.PCw++;
-				CPU.Cycles += TWO_CYCLES + ONE_DOT_CYCLE / 2;
-				while (CPU.Cycles >= CPU.NextEvent)
-					S9xDoHEventProcessing();
+				for (int Break = 0; Break != 6; Break++)
+				{
+					if (S9xBreakpoint[Break].Enabled &&
+						S9xBreakpoint[Break].Bank == Registers.PB &&
+						S9xBreakpoint[Break].Address == Registers.PCw)
+					{
+						if (S9xBreakpoint[Break].Enabled == 2)
+							S9xBreakpoint[Break].Enabled = TRUE;
+						else
+							CPU.Flags |= DEBUG_MODE_FLAG;
+					}
+				}
 			}
 
-			if (!CheckFlag(IRQ))
+			if (CPU.Flags & DEBUG_MODE_FLAG)
+				break;
+
+			if (CPU.Flags & TRACE_FLAG)
+				S9xTrace();
+
+			if (CPU.Flags & SINGLE_STEP_FLAG)
 			{
-				/* The flag pushed onto the stack is the new value */
-				CHECK_FOR_IRQ_CHANGE();
-				S9xOpcode_IRQ();
+				CPU.Flags &= ~SINGLE_STEP_FLAG;
+				CPU.Flags |= DEBUG_MODE_FLAG;
 			}
-		}
-
-		/* Change IRQ flag for instructions that set it only on last cycle */
-		CHECK_FOR_IRQ_CHANGE();
+		#endif
 
-	#ifdef DEBUGGER
-		if ((CPU.Flags & BREAK_FLAG) && !(CPU.Flags & SINGLE_STEP_FLAG))
-		{
-			for (int Break = 0; Break != 6; Break++)
+			if (CPU.Flags & SCAN_KEYS_FLAG)
 			{
-				if (S9xBreakpoint[Break].Enabled &&
-					S9xBreakpoint[Break].Bank == Registers.PB &&
-					S9xBreakpoint[Break].Address == Registers.PCw)
+				#ifdef DEBUGGER
+				if (!(CPU.Flags & FRAME_ADVANCE_FLAG))
+				#endif
+				if (!RunAhead.Hidden)
 				{
-					if (S9xBreakpoint[Break].Enabled == 2)
-						S9xBreakpoint[Break].Enabled = TRUE;
-					else
-						CPU.Flags |= DEBUG_MODE_FLAG;
+					PROFILE_ENTER(PROF_FRONTEND);
+					S9xSyncSpeed();
+					PROFILE_LEAVE();
 				}
-			}
-		}
-
-		if (CPU.Flags & DEBUG_MODE_FLAG)
-			break;
-
-		if (CPU.Flags & TRACE_FLAG)
-			S9xTrace();
 
-		if (CPU.Flags & SINGLE_STEP_FLAG)
-		{
-			CPU.Flags &= ~SINGLE_STEP_FLAG;
-			CPU.Flags |= DEBUG_MODE_FLAG;
-		}
-	#endif
-
-		if (CPU.Flags & SCAN_KEYS_FLAG)
-		{
-			#ifdef DEBUGGER
-			if (!(CPU.Flags & FRAME_ADVANCE_FLAG))
-			#endif
-			{
-				S9xSyncSpeed();
+				break;
 			}
 
-			break;
+			S9xUpdateInterruptHorizon();
 		}
 
+	#ifdef CPU_BLOCK_CACHE
+		if (CPU.PCBase && !CPU.WaitingForInterrupt && S9xRunCachedBlock())
+			continue;
+	#endif
+
 		uint8				Op;
 		struct	SOpcodes	*Opcodes;
 
@@ -156,6 +313,7 @@ void S9xMainLoop (void)
 			Op = S9xGetByte(Registers.PBPC);
 			OpenBus = Op;
 			Opcodes = S9xOpcodesSlow;
+			OPSTATS_NO_PCBASE();
 		}
 
 		if ((Registers.PCw & MEMMAP_MASK) + ICPU.S9xOpLengths[Op] >= MEMMAP_BLOCK_SIZE)
@@ -167,14 +325,23 @@ void S9xMainLoop (void)
 				Opcodes = S9xOpcodesSlow;
 		}
 
+		OPSTATS_RECORD(Op, Registers.PBPC, Opcodes == S9xOpcodesSlow);
 		Registers.PCw++;
+		PROFILE_OPCODE();
 		(*Opcodes[Op].S9xOpcode)();
 
 		if (Settings.SA1)
+		{
+			PROFILE_ENTER(PROF_SA1);
 			S9xSA1MainLoop();
+			PROFILE_LEAVE();
+		}
 	}
 
 	S9xPackStatus();
+
+	PROFILE_LEAVE();
+	PROFILE_END_FRAME();
 }
 
 static inline void S9xReschedule (void)
@@ -234,6 +401,8 @@ void S9xDoHEventProcessing (void)
 			eventname[CPU.WhichEvent], CPU.NextEvent, CPU.Cycles, CPU.V_Counter);
 #endif
 
+	PROFILE_ENTER(PROF_HEVENT);
+
 	switch (CPU.WhichEvent)
 	{
 		case HC_HBLANK_START_EVENT:
@@ -248,7 +417,9 @@ void S9xDoHEventProcessing (void)
 			#ifdef DEBUGGER
 				S9xTraceFormattedMessage("*** HDMA Transfer HC:%04d, Channel:%02x", CPU.Cycles, PPU.HDMA);
 			#endif
+				PROFILE_ENTER(PROF_HDMA);
 				PPU.HDMA = S9xDoHDMA(PPU.HDMA);
+				PROFILE_LEAVE();
 			}
 
 			break;
@@ -326,6 +497,8 @@ void S9xDoHEventProcessing (void)
 
 			if (CPU.V_Counter == PPU.ScreenHeight + FIRST_VISIBLE_LINE)	// VBlank starts from V=225(240).
 			{
+				// Hand the frontend every sample of the frame before S9xMainLoop returns
+				S9xAPUSync();
 				S9xEndScreenRefresh();
 
 				CPU.Flags |= SCAN_KEYS_FLAG;
@@ -381,6 +554,7 @@ void S9xDoHEventProcessing (void)
 				S9xStartScreenRefresh();
 
 			S9xReschedule();
+			S9xUpdateInterruptHorizon();
 
 			break;
 
@@ -392,7 +566,9 @@ void S9xDoHEventProcessing (void)
 			#ifdef DEBUGGER
 				S9xTraceFormattedMessage("*** HDMA Init     HC:%04d, Channel:%02x", CPU.Cycles, PPU.HDMA);
 			#endif
+				PROFILE_ENTER(PROF_HDMA);
 				S9xStartHDMA();
+				PROFILE_LEAVE();
 			}
 
 			break;
@@ -417,6 +593,8 @@ void S9xDoHEventProcessing (void)
 			break;
 	}
 
+	PROFILE_LEAVE();
+
 #ifdef DEBUGGER
 	if (Settings.TraceHCEvent)
 		S9xTraceFormattedMessage("--- HC event rescheduled (%s)  expected HC:%04d  current  HC:%04d",
@@ -12,6 +12,12 @@
 #include "debug.h"
 #endif
 
+// Basic-block cache for ROM-resident code, see S9xRunCachedBlock().
+// The debugger needs to see every instruction, so it's left out there.
+#if !defined(DEBUGGER) && !defined(NO_BLOCK_CACHE)
+#define CPU_BLOCK_CACHE
+#endif
+
 struct SOpcodes
 {
 	void (*S9xOpcode) (void);
@@ -48,6 +54,34 @@ void S9xMainLoop (void);
 void S9xReset (void);
 void S9xSoftReset (void);
 void S9xDoHEventProcessing (void);
+void S9xBlockCacheFlush (void);
+
+// The top of S9xMainLoop only has work to do (NMI, IRQ, IRQ flag change, end
+// of frame) once CPU.Cycles reaches CPU.InterruptHorizon, so the common case
+// is a single compare per instruction. H-events stay on CPU.NextEvent and are
+// still polled per access, as HDMA and rendering happen mid-instruction.
+// Anything that raises one of these conditions from inside an instruction has
+// to call S9xScheduleInterruptCheck(); checking early is always harmless.
+static inline void S9xUpdateInterruptHorizon (void)
+{
+#ifdef DEBUGGER
+	CPU.InterruptHorizon = 0;
+#else
+	if (CPU.IRQLine || CPU.IRQExternal || Timings.IRQFlagChanging || (CPU.Flags & SCAN_KEYS_FLAG))
+		CPU.InterruptHorizon = 0;
+	else
+	{
+		CPU.InterruptHorizon = Timings.NextIRQTimer;
+		if (CPU.NMIPending && Timings.NMITriggerPos < CPU.InterruptHorizon)
+			CPU.InterruptHorizon = Timings.NMITriggerPos;
+	}
+#endif
+}
+
+static inline void S9xScheduleInterruptCheck (void)
+{
+	CPU.InterruptHorizon = 0;
+}
 
 static inline void S9xUnpackStatus (void)
 {
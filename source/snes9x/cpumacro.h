@@ -17,7 +17,7 @@ static void Op##OP (void) \
 #define rOP16(OP, ADDR, WRAP, FUNC) \
 static void Op##OP (void) \
 { \
-	uint16	val = S9xGetWord(ADDR(READ), WRAP); \
+	uint16	val = S9xGetWord<WRAP>(ADDR(READ)); \
 	OpenBus = (uint8) (val >> 8); \
 	FUNC(val); \
 }
@@ -32,7 +32,7 @@ static void Op##OP (void) \
 	} \
 	else \
 	{ \
-		uint16	val = S9xGetWord(ADDR(READ), WRAP); \
+		uint16	val = S9xGetWord<WRAP>(ADDR(READ)); \
 		OpenBus = (uint8) (val >> 8); \
 		FUNC(val); \
 	} \
@@ -53,7 +53,7 @@ static void Op##OP (void) \
 #define wOP16(OP, ADDR, WRAP, FUNC) \
 static void Op##OP (void) \
 { \
-	FUNC##16(ADDR(WRITE), WRAP); \
+	FUNC##16<WRAP>(ADDR(WRITE)); \
 }
 
 #define wOPC(OP, COND, ADDR, WRAP, FUNC) \
@@ -62,7 +62,7 @@ static void Op##OP (void) \
 	if (Check##COND()) \
 		FUNC##8(ADDR(WRITE)); \
 	else \
-		FUNC##16(ADDR(WRITE), WRAP); \
+		FUNC##16<WRAP>(ADDR(WRITE)); \
 }
 
 #define wOPM(OP, ADDR, WRAP, FUNC) \
@@ -80,7 +80,7 @@ static void Op##OP (void) \
 #define mOP16(OP, ADDR, WRAP, FUNC) \
 static void Op##OP (void) \
 { \
-	FUNC##16(ADDR(MODIFY), WRAP); \
+	FUNC##16<WRAP>(ADDR(MODIFY)); \
 }
 
 #define mOPC(OP, COND, ADDR, WRAP, FUNC) \
@@ -89,7 +89,7 @@ static void Op##OP (void) \
 	if (Check##COND()) \
 		FUNC##8(ADDR(MODIFY)); \
 	else \
-		FUNC##16(ADDR(MODIFY), WRAP); \
+		FUNC##16<WRAP>(ADDR(MODIFY)); \
 }
 
 #define mOPM(OP, ADDR, WRAP, FUNC) \
@@ -239,13 +239,14 @@ static inline void AND (uint8 Work8)
 	SetZN(Registers.AL);
 }
 
-static inline void ASL16 (uint32 OpAddress, s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void ASL16 (uint32 OpAddress)
 {
-	uint16	Work16 = S9xGetWord(OpAddress, w);
+	uint16	Work16 = S9xGetWord<w>(OpAddress);
 	ICPU._Carry = (Work16 & 0x8000) != 0;
 	Work16 <<= 1;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord(Work16, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>(Work16, OpAddress);
 	OpenBus = Work16 & 0xff;
 	SetZN(Work16);
 }
@@ -317,11 +318,12 @@ static inline void CPY (uint8 val)
 	SetZN((uint8) Int16);
 }
 
-static inline void DEC16 (uint32 OpAddress, s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void DEC16 (uint32 OpAddress)
 {
-	uint16	Work16 = S9xGetWord(OpAddress, w) - 1;
+	uint16	Work16 = S9xGetWord<w>(OpAddress) - 1;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord(Work16, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>(Work16, OpAddress);
 	OpenBus = Work16 & 0xff;
 	SetZN(Work16);
 }
@@ -347,11 +349,12 @@ static inline void EOR (uint8 val)
 	SetZN(Registers.AL);
 }
 
-static inline void INC16 (uint32 OpAddress, s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void INC16 (uint32 OpAddress)
 {
-	uint16	Work16 = S9xGetWord(OpAddress, w) + 1;
+	uint16	Work16 = S9xGetWord<w>(OpAddress) + 1;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord(Work16, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>(Work16, OpAddress);
 	OpenBus = Work16 & 0xff;
 	SetZN(Work16);
 }
@@ -401,13 +404,14 @@ static inline void LDY (uint8 val)
 	SetZN(Registers.YL);
 }
 
-static inline void LSR16 (uint32 OpAddress, s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void LSR16 (uint32 OpAddress)
 {
-	uint16	Work16 = S9xGetWord(OpAddress, w);
+	uint16	Work16 = S9xGetWord<w>(OpAddress);
 	ICPU._Carry = Work16 & 1;
 	Work16 >>= 1;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord(Work16, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>(Work16, OpAddress);
 	OpenBus = Work16 & 0xff;
 	SetZN(Work16);
 }
@@ -435,12 +439,13 @@ static inline void ORA (uint8 val)
 	SetZN(Registers.AL);
 }
 
-static inline void ROL16 (uint32 OpAddress, s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void ROL16 (uint32 OpAddress)
 {
-	uint32	Work32 = (((uint32) S9xGetWord(OpAddress, w)) << 1) | CheckCarry();
+	uint32	Work32 = (((uint32) S9xGetWord<w>(OpAddress)) << 1) | CheckCarry();
 	ICPU._Carry = Work32 >= 0x10000;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord((uint16) Work32, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>((uint16) Work32, OpAddress);
 	OpenBus = Work32 & 0xff;
 	SetZN((uint16) Work32);
 }
@@ -455,13 +460,14 @@ static inline void ROL8 (uint32 OpAddress)
 	SetZN((uint8) Work16);
 }
 
-static inline void ROR16 (uint32 OpAddress, s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void ROR16 (uint32 OpAddress)
 {
-	uint32	Work32 = ((uint32) S9xGetWord(OpAddress, w)) | (((uint32) CheckCarry()) << 16);
+	uint32	Work32 = ((uint32) S9xGetWord<w>(OpAddress)) | (((uint32) CheckCarry()) << 16);
 	ICPU._Carry = Work32 & 1;
 	Work32 >>= 1;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord((uint16) Work32, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>((uint16) Work32, OpAddress);
 	OpenBus = Work32 & 0xff;
 	SetZN((uint16) Work32);
 }
@@ -583,9 +589,10 @@ static inline void SBC (uint8 Work8)
 	}
 }
 
-static inline void STA16 (uint32 OpAddress, enum s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void STA16 (uint32 OpAddress)
 {
-	S9xSetWord(Registers.A.W, OpAddress, w);
+	S9xSetWord<w, WRITE_01>(Registers.A.W, OpAddress);
 	OpenBus = Registers.AH;
 }
 
@@ -595,9 +602,10 @@ static inline void STA8 (uint32 OpAddress)
 	OpenBus = Registers.AL;
 }
 
-static inline void STX16 (uint32 OpAddress, enum s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void STX16 (uint32 OpAddress)
 {
-	S9xSetWord(Registers.X.W, OpAddress, w);
+	S9xSetWord<w, WRITE_01>(Registers.X.W, OpAddress);
 	OpenBus = Registers.XH;
 }
 
@@ -607,9 +615,10 @@ static inline void STX8 (uint32 OpAddress)
 	OpenBus = Registers.XL;
 }
 
-static inline void STY16 (uint32 OpAddress, enum s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void STY16 (uint32 OpAddress)
 {
-	S9xSetWord(Registers.Y.W, OpAddress, w);
+	S9xSetWord<w, WRITE_01>(Registers.Y.W, OpAddress);
 	OpenBus = Registers.YH;
 }
 
@@ -619,9 +628,10 @@ static inline void STY8 (uint32 OpAddress)
 	OpenBus = Registers.YL;
 }
 
-static inline void STZ16 (uint32 OpAddress, enum s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void STZ16 (uint32 OpAddress)
 {
-	S9xSetWord(0, OpAddress, w);
+	S9xSetWord<w, WRITE_01>(0, OpAddress);
 	OpenBus = 0;
 }
 
@@ -631,13 +641,14 @@ static inline void STZ8 (uint32 OpAddress)
 	OpenBus = 0;
 }
 
-static inline void TSB16 (uint32 OpAddress, enum s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void TSB16 (uint32 OpAddress)
 {
-	uint16	Work16 = S9xGetWord(OpAddress, w);
+	uint16	Work16 = S9xGetWord<w>(OpAddress);
 	ICPU._Zero = (Work16 & Registers.A.W) != 0;
 	Work16 |= Registers.A.W;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord(Work16, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>(Work16, OpAddress);
 	OpenBus = Work16 & 0xff;
 }
 
@@ -651,13 +662,14 @@ static inline void TSB8 (uint32 OpAddress)
 	OpenBus = Work8;
 }
 
-static inline void TRB16 (uint32 OpAddress, enum s9xwrap_t w)
+template <enum s9xwrap_t w>
+static inline void TRB16 (uint32 OpAddress)
 {
-	uint16	Work16 = S9xGetWord(OpAddress, w);
+	uint16	Work16 = S9xGetWord<w>(OpAddress);
 	ICPU._Zero = (Work16 & Registers.A.W) != 0;
 	Work16 &= ~Registers.A.W;
 	AddCycles(ONE_CYCLE);
-	S9xSetWord(Work16, OpAddress, w, WRITE_10);
+	S9xSetWord<w, WRITE_10>(Work16, OpAddress);
 	OpenBus = Work16 & 0xff;
 }
 
@@ -1455,6 +1455,7 @@ static void Op58 (void)
 
 #ifndef SA1_OPCODES
 	Timings.IRQFlagChanging |= IRQ_CLEAR_FLAG;
+	S9xScheduleInterruptCheck();
 #else
 	ClearIRQ();
 #endif
@@ -1467,6 +1468,7 @@ static void Op78 (void)
 
 #ifndef SA1_OPCODES
 	Timings.IRQFlagChanging |= IRQ_SET_FLAG;
+	S9xScheduleInterruptCheck();
 #else
 	SetIRQ();
 #endif
@@ -1613,12 +1615,12 @@ static void OpEA (void)
 /* PUSH Instructions ******************************************************* */
 
 #define PushW(w) \
-	S9xSetWord(w, Registers.S.W - 1, WRAP_BANK, WRITE_10); \
+	S9xSetWord<WRAP_BANK, WRITE_10>(w, Registers.S.W - 1); \
 	Registers.S.W -= 2;
 
 #define PushWE(w) \
 	Registers.SL--; \
-	S9xSetWord(w, Registers.S.W, WRAP_PAGE, WRITE_10); \
+	S9xSetWord<WRAP_PAGE, WRITE_10>(w, Registers.S.W); \
 	Registers.SL--;
 
 #define PushB(b) \
@@ -1964,12 +1966,12 @@ static void Op5ASlow (void)
 /* PULL Instructions ******************************************************* */
 
 #define PullW(w) \
-	w = S9xGetWord(Registers.S.W + 1, WRAP_BANK); \
+	w = S9xGetWord<WRAP_BANK>(Registers.S.W + 1); \
 	Registers.S.W += 2;
 
 #define PullWE(w) \
 	Registers.SL++; \
-	w = S9xGetWord(Registers.S.W, WRAP_PAGE); \
+	w = S9xGetWord<WRAP_PAGE>(Registers.S.W); \
 	Registers.SL++;
 
 #define PullB(b) \
@@ -2326,7 +2328,20 @@ static void Op5B (void)
 }
 
 // TCS
-static void Op1B (void)
+static void Op1BE1 (void)
+{
+	AddCycles(ONE_CYCLE);
+	Registers.S.W = Registers.A.W;
+	Registers.SH = 1;
+}
+
+static void Op1BE0 (void)
+{
+	AddCycles(ONE_CYCLE);
+	Registers.S.W = Registers.A.W;
+}
+
+static void Op1BSlow (void)
 {
 	AddCycles(ONE_CYCLE);
 	Registers.S.W = Registers.A.W;
@@ -2413,7 +2428,20 @@ static void Op8ASlow (void)
 }
 
 // TXS
-static void Op9A (void)
+static void Op9AE1 (void)
+{
+	AddCycles(ONE_CYCLE);
+	Registers.S.W = Registers.X.W;
+	Registers.SH = 1;
+}
+
+static void Op9AE0 (void)
+{
+	AddCycles(ONE_CYCLE);
+	Registers.S.W = Registers.X.W;
+}
+
+static void Op9ASlow (void)
 {
 	AddCycles(ONE_CYCLE);
 	Registers.S.W = Registers.X.W;
@@ -2546,7 +2574,7 @@ static void OpFB (void)
 
 /* BRK ********************************************************************* */
 
-static void Op00 (void)
+static void Op00E0 (void)
 {
 #ifdef DEBUGGER
 	if (CPU.Flags & TRACE_FLAG)
@@ -2555,36 +2583,50 @@ static void Op00 (void)
 
 	AddCycles(CPU.MemSpeed);
 
-	uint16	addr;
+	PushB(Registers.PB);
+	PushW(Registers.PCw + 1);
+	S9xPackStatus();
+	PushB(Registers.PL);
+	OpenBus = Registers.PL;
+	ClearDecimal();
+	SetIRQ();
+
+	uint16	addr = S9xGetWord(0xFFE6);
 
-	if (!CheckEmulation())
-	{
-		PushB(Registers.PB);
-		PushW(Registers.PCw + 1);
-		S9xPackStatus();
-		PushB(Registers.PL);
-		OpenBus = Registers.PL;
-		ClearDecimal();
-		SetIRQ();
+	S9xSetPCBase(addr);
+	OpenBus = addr >> 8;
+}
 
-		addr = S9xGetWord(0xFFE6);
-	}
-	else
-	{
-		PushWE(Registers.PCw + 1);
-		S9xPackStatus();
-		PushBE(Registers.PL);
-		OpenBus = Registers.PL;
-		ClearDecimal();
-		SetIRQ();
+static void Op00E1 (void)
+{
+#ifdef DEBUGGER
+	if (CPU.Flags & TRACE_FLAG)
+		S9xTraceMessage("*** BRK");
+#endif
 
-		addr = S9xGetWord(0xFFFE);
-	}
+	AddCycles(CPU.MemSpeed);
+
+	PushWE(Registers.PCw + 1);
+	S9xPackStatus();
+	PushBE(Registers.PL);
+	OpenBus = Registers.PL;
+	ClearDecimal();
+	SetIRQ();
+
+	uint16	addr = S9xGetWord(0xFFFE);
 
 	S9xSetPCBase(addr);
 	OpenBus = addr >> 8;
 }
 
+static void Op00Slow (void)
+{
+	if (CheckEmulation())
+		Op00E1();
+	else
+		Op00E0();
+}
+
 /* IRQ ********************************************************************* */
 
 void S9xOpcode_IRQ (void)
@@ -2737,7 +2779,7 @@ void S9xOpcode_NMI (void)
 
 /* COP ********************************************************************* */
 
-static void Op02 (void)
+static void Op02E0 (void)
 {
 #ifdef DEBUGGER
 	if (CPU.Flags & TRACE_FLAG)
@@ -2746,36 +2788,50 @@ static void Op02 (void)
 
 	AddCycles(CPU.MemSpeed);
 
-	uint16	addr;
+	PushB(Registers.PB);
+	PushW(Registers.PCw + 1);
+	S9xPackStatus();
+	PushB(Registers.PL);
+	OpenBus = Registers.PL;
+	ClearDecimal();
+	SetIRQ();
 
-	if (!CheckEmulation())
-	{
-		PushB(Registers.PB);
-		PushW(Registers.PCw + 1);
-		S9xPackStatus();
-		PushB(Registers.PL);
-		OpenBus = Registers.PL;
-		ClearDecimal();
-		SetIRQ();
+	uint16	addr = S9xGetWord(0xFFE4);
 
-		addr = S9xGetWord(0xFFE4);
-	}
-	else
-	{
-		PushWE(Registers.PCw + 1);
-		S9xPackStatus();
-		PushBE(Registers.PL);
-		OpenBus = Registers.PL;
-		ClearDecimal();
-		SetIRQ();
+	S9xSetPCBase(addr);
+	OpenBus = addr >> 8;
+}
 
-		addr = S9xGetWord(0xFFF4);
-	}
+static void Op02E1 (void)
+{
+#ifdef DEBUGGER
+	if (CPU.Flags & TRACE_FLAG)
+		S9xTraceMessage("*** COP");
+#endif
+
+	AddCycles(CPU.MemSpeed);
+
+	PushWE(Registers.PCw + 1);
+	S9xPackStatus();
+	PushBE(Registers.PL);
+	OpenBus = Registers.PL;
+	ClearDecimal();
+	SetIRQ();
+
+	uint16	addr = S9xGetWord(0xFFF4);
 
 	S9xSetPCBase(addr);
 	OpenBus = addr >> 8;
 }
 
+static void Op02Slow (void)
+{
+	if (CheckEmulation())
+		Op02E1();
+	else
+		Op02E0();
+}
+
 /* JML ********************************************************************* */
 
 static void OpDC (void)
@@ -3406,12 +3462,12 @@ static void Op42 (void)
 
 struct SOpcodes S9xOpcodesM1X1[256] =
 {
-	{ Op00 },        { Op01E0M1 },    { Op02 },        { Op03M1 },      { Op04M1 },
+	{ Op00E0 },      { Op01E0M1 },    { Op02E0 },      { Op03M1 },      { Op04M1 },
 	{ Op05M1 },      { Op06M1 },      { Op07M1 },      { Op08E0 },      { Op09M1 },
 	{ Op0AM1 },      { Op0BE0 },      { Op0CM1 },      { Op0DM1 },      { Op0EM1 },
 	{ Op0FM1 },      { Op10E0 },      { Op11E0M1X1 },  { Op12E0M1 },    { Op13M1 },
 	{ Op14M1 },      { Op15E0M1 },    { Op16E0M1 },    { Op17M1 },      { Op18 },
-	{ Op19M1X1 },    { Op1AM1 },      { Op1B },        { Op1CM1 },      { Op1DM1X1 },
+	{ Op19M1X1 },    { Op1AM1 },      { Op1BE0 },      { Op1CM1 },      { Op1DM1X1 },
 	{ Op1EM1X1 },    { Op1FM1 },      { Op20E0 },      { Op21E0M1 },    { Op22E0 },
 	{ Op23M1 },      { Op24M1 },      { Op25M1 },      { Op26M1 },      { Op27M1 },
 	{ Op28E0 },      { Op29M1 },      { Op2AM1 },      { Op2BE0 },      { Op2CM1 },
@@ -3436,7 +3492,7 @@ struct SOpcodes S9xOpcodesM1X1[256] =
 	{ Op87M1 },      { Op88X1 },      { Op89M1 },      { Op8AM1 },      { Op8BE0 },
 	{ Op8CX1 },      { Op8DM1 },      { Op8EX1 },      { Op8FM1 },      { Op90E0 },
 	{ Op91E0M1X1 },  { Op92E0M1 },    { Op93M1 },      { Op94E0X1 },    { Op95E0M1 },
-	{ Op96E0X1 },    { Op97M1 },      { Op98M1 },      { Op99M1X1 },    { Op9A },
+	{ Op96E0X1 },    { Op97M1 },      { Op98M1 },      { Op99M1X1 },    { Op9AE0 },
 	{ Op9BX1 },      { Op9CM1 },      { Op9DM1X1 },    { Op9EM1X1 },    { Op9FM1 },
 	{ OpA0X1 },      { OpA1E0M1 },    { OpA2X1 },      { OpA3M1 },      { OpA4X1 },
 	{ OpA5M1 },      { OpA6X1 },      { OpA7M1 },      { OpA8X1 },      { OpA9M1 },
@@ -3462,12 +3518,12 @@ struct SOpcodes S9xOpcodesM1X1[256] =
 
 struct SOpcodes S9xOpcodesE1[256] =
 {
-	{ Op00 },        { Op01E1 },      { Op02 },        { Op03M1 },      { Op04M1 },
+	{ Op00E1 },      { Op01E1 },      { Op02E1 },      { Op03M1 },      { Op04M1 },
 	{ Op05M1 },      { Op06M1 },      { Op07M1 },      { Op08E1 },      { Op09M1 },
 	{ Op0AM1 },      { Op0BE1 },      { Op0CM1 },      { Op0DM1 },      { Op0EM1 },
 	{ Op0FM1 },      { Op10E1 },      { Op11E1 },      { Op12E1 },      { Op13M1 },
 	{ Op14M1 },      { Op15E1 },      { Op16E1 },      { Op17M1 },      { Op18 },
-	{ Op19M1X1 },    { Op1AM1 },      { Op1B },        { Op1CM1 },      { Op1DM1X1 },
+	{ Op19M1X1 },    { Op1AM1 },      { Op1BE1 },      { Op1CM1 },      { Op1DM1X1 },
 	{ Op1EM1X1 },    { Op1FM1 },      { Op20E1 },      { Op21E1 },      { Op22E1 },
 	{ Op23M1 },      { Op24M1 },      { Op25M1 },      { Op26M1 },      { Op27M1 },
 	{ Op28E1 },      { Op29M1 },      { Op2AM1 },      { Op2BE1 },      { Op2CM1 },
@@ -3492,7 +3548,7 @@ struct SOpcodes S9xOpcodesE1[256] =
 	{ Op87M1 },      { Op88X1 },      { Op89M1 },      { Op8AM1 },      { Op8BE1 },
 	{ Op8CX1 },      { Op8DM1 },      { Op8EX1 },      { Op8FM1 },      { Op90E1 },
 	{ Op91E1 },      { Op92E1 },      { Op93M1 },      { Op94E1 },      { Op95E1 },
-	{ Op96E1 },      { Op97M1 },      { Op98M1 },      { Op99M1X1 },    { Op9A },
+	{ Op96E1 },      { Op97M1 },      { Op98M1 },      { Op99M1X1 },    { Op9AE1 },
 	{ Op9BX1 },      { Op9CM1 },      { Op9DM1X1 },    { Op9EM1X1 },    { Op9FM1 },
 	{ OpA0X1 },      { OpA1E1 },      { OpA2X1 },      { OpA3M1 },      { OpA4X1 },
 	{ OpA5M1 },      { OpA6X1 },      { OpA7M1 },      { OpA8X1 },      { OpA9M1 },
@@ -3518,12 +3574,12 @@ struct SOpcodes S9xOpcodesE1[256] =
 
 struct SOpcodes S9xOpcodesM1X0[256] =
 {
-	{ Op00 },        { Op01E0M1 },    { Op02 },        { Op03M1 },      { Op04M1 },
+	{ Op00E0 },      { Op01E0M1 },    { Op02E0 },      { Op03M1 },      { Op04M1 },
 	{ Op05M1 },      { Op06M1 },      { Op07M1 },      { Op08E0 },      { Op09M1 },
 	{ Op0AM1 },      { Op0BE0 },      { Op0CM1 },      { Op0DM1 },      { Op0EM1 },
 	{ Op0FM1 },      { Op10E0 },      { Op11E0M1X0 },  { Op12E0M1 },    { Op13M1 },
 	{ Op14M1 },      { Op15E0M1 },    { Op16E0M1 },    { Op17M1 },      { Op18 },
-	{ Op19M1X0 },    { Op1AM1 },      { Op1B },        { Op1CM1 },      { Op1DM1X0 },
+	{ Op19M1X0 },    { Op1AM1 },      { Op1BE0 },      { Op1CM1 },      { Op1DM1X0 },
 	{ Op1EM1X0 },    { Op1FM1 },      { Op20E0 },      { Op21E0M1 },    { Op22E0 },
 	{ Op23M1 },      { Op24M1 },      { Op25M1 },      { Op26M1 },      { Op27M1 },
 	{ Op28E0 },      { Op29M1 },      { Op2AM1 },      { Op2BE0 },      { Op2CM1 },
@@ -3548,7 +3604,7 @@ struct SOpcodes S9xOpcodesM1X0[256] =
 	{ Op87M1 },      { Op88X0 },      { Op89M1 },      { Op8AM1 },      { Op8BE0 },
 	{ Op8CX0 },      { Op8DM1 },      { Op8EX0 },      { Op8FM1 },      { Op90E0 },
 	{ Op91E0M1X0 },  { Op92E0M1 },    { Op93M1 },      { Op94E0X0 },    { Op95E0M1 },
-	{ Op96E0X0 },    { Op97M1 },      { Op98M1 },      { Op99M1X0 },    { Op9A },
+	{ Op96E0X0 },    { Op97M1 },      { Op98M1 },      { Op99M1X0 },    { Op9AE0 },
 	{ Op9BX0 },      { Op9CM1 },      { Op9DM1X0 },    { Op9EM1X0 },    { Op9FM1 },
 	{ OpA0X0 },      { OpA1E0M1 },    { OpA2X0 },      { OpA3M1 },      { OpA4X0 },
 	{ OpA5M1 },      { OpA6X0 },      { OpA7M1 },      { OpA8X0 },      { OpA9M1 },
@@ -3574,12 +3630,12 @@ struct SOpcodes S9xOpcodesM1X0[256] =
 
 struct SOpcodes S9xOpcodesM0X0[256] =
 {
-	{ Op00 },        { Op01E0M0 },    { Op02 },        { Op03M0 },      { Op04M0 },
+	{ Op00E0 },      { Op01E0M0 },    { Op02E0 },      { Op03M0 },      { Op04M0 },
 	{ Op05M0 },      { Op06M0 },      { Op07M0 },      { Op08E0 },      { Op09M0 },
 	{ Op0AM0 },      { Op0BE0 },      { Op0CM0 },      { Op0DM0 },      { Op0EM0 },
 	{ Op0FM0 },      { Op10E0 },      { Op11E0M0X0 },  { Op12E0M0 },    { Op13M0 },
 	{ Op14M0 },      { Op15E0M0 },    { Op16E0M0 },    { Op17M0 },      { Op18 },
-	{ Op19M0X0 },    { Op1AM0 },      { Op1B },        { Op1CM0 },      { Op1DM0X0 },
+	{ Op19M0X0 },    { Op1AM0 },      { Op1BE0 },      { Op1CM0 },      { Op1DM0X0 },
 	{ Op1EM0X0 },    { Op1FM0 },      { Op20E0 },      { Op21E0M0 },    { Op22E0 },
 	{ Op23M0 },      { Op24M0 },      { Op25M0 },      { Op26M0 },      { Op27M0 },
 	{ Op28E0 },      { Op29M0 },      { Op2AM0 },      { Op2BE0 },      { Op2CM0 },
@@ -3604,7 +3660,7 @@ struct SOpcodes S9xOpcodesM0X0[256] =
 	{ Op87M0 },      { Op88X0 },      { Op89M0 },      { Op8AM0 },      { Op8BE0 },
 	{ Op8CX0 },      { Op8DM0 },      { Op8EX0 },      { Op8FM0 },      { Op90E0 },
 	{ Op91E0M0X0 },  { Op92E0M0 },    { Op93M0 },      { Op94E0X0 },    { Op95E0M0 },
-	{ Op96E0X0 },    { Op97M0 },      { Op98M0 },      { Op99M0X0 },    { Op9A },
+	{ Op96E0X0 },    { Op97M0 },      { Op98M0 },      { Op99M0X0 },    { Op9AE0 },
 	{ Op9BX0 },      { Op9CM0 },      { Op9DM0X0 },    { Op9EM0X0 },    { Op9FM0 },
 	{ OpA0X0 },      { OpA1E0M0 },    { OpA2X0 },      { OpA3M0 },      { OpA4X0 },
 	{ OpA5M0 },      { OpA6X0 },      { OpA7M0 },      { OpA8X0 },      { OpA9M0 },
@@ -3630,12 +3686,12 @@ struct SOpcodes S9xOpcodesM0X0[256] =
 
 struct SOpcodes S9xOpcodesM0X1[256] =
 {
-	{ Op00 },        { Op01E0M0 },    { Op02 },        { Op03M0 },      { Op04M0 },
+	{ Op00E0 },      { Op01E0M0 },    { Op02E0 },      { Op03M0 },      { Op04M0 },
 	{ Op05M0 },      { Op06M0 },      { Op07M0 },      { Op08E0 },      { Op09M0 },
 	{ Op0AM0 },      { Op0BE0 },      { Op0CM0 },      { Op0DM0 },      { Op0EM0 },
 	{ Op0FM0 },      { Op10E0 },      { Op11E0M0X1 },  { Op12E0M0 },    { Op13M0 },
 	{ Op14M0 },      { Op15E0M0 },    { Op16E0M0 },    { Op17M0 },      { Op18 },
-	{ Op19M0X1 },    { Op1AM0 },      { Op1B },        { Op1CM0 },      { Op1DM0X1 },
+	{ Op19M0X1 },    { Op1AM0 },      { Op1BE0 },      { Op1CM0 },      { Op1DM0X1 },
 	{ Op1EM0X1 },    { Op1FM0 },      { Op20E0 },      { Op21E0M0 },    { Op22E0 },
 	{ Op23M0 },      { Op24M0 },      { Op25M0 },      { Op26M0 },      { Op27M0 },
 	{ Op28E0 },      { Op29M0 },      { Op2AM0 },      { Op2BE0 },      { Op2CM0 },
@@ -3660,7 +3716,7 @@ struct SOpcodes S9xOpcodesM0X1[256] =
 	{ Op87M0 },      { Op88X1 },      { Op89M0 },      { Op8AM0 },      { Op8BE0 },
 	{ Op8CX1 },      { Op8DM0 },      { Op8EX1 },      { Op8FM0 },      { Op90E0 },
 	{ Op91E0M0X1 },  { Op92E0M0 },    { Op93M0 },      { Op94E0X1 },    { Op95E0M0 },
-	{ Op96E0X1 },    { Op97M0 },      { Op98M0 },      { Op99M0X1 },    { Op9A },
+	{ Op96E0X1 },    { Op97M0 },      { Op98M0 },      { Op99M0X1 },    { Op9AE0 },
 	{ Op9BX1 },      { Op9CM0 },      { Op9DM0X1 },    { Op9EM0X1 },    { Op9FM0 },
 	{ OpA0X1 },      { OpA1E0M0 },    { OpA2X1 },      { OpA3M0 },      { OpA4X1 },
 	{ OpA5M0 },      { OpA6X1 },      { OpA7M0 },      { OpA8X1 },      { OpA9M0 },
@@ -3686,12 +3742,12 @@ struct SOpcodes S9xOpcodesM0X1[256] =
 
 struct SOpcodes S9xOpcodesSlow[256] =
 {
-	{ Op00 },        { Op01Slow },    { Op02 },        { Op03Slow },    { Op04Slow },
+	{ Op00Slow },    { Op01Slow },    { Op02Slow },    { Op03Slow },    { Op04Slow },
 	{ Op05Slow },    { Op06Slow },    { Op07Slow },    { Op08Slow },    { Op09Slow },
 	{ Op0ASlow },    { Op0BSlow },    { Op0CSlow },    { Op0DSlow },    { Op0ESlow },
 	{ Op0FSlow },    { Op10Slow },    { Op11Slow },    { Op12Slow },    { Op13Slow },
 	{ Op14Slow },    { Op15Slow },    { Op16Slow },    { Op17Slow },    { Op18 },
-	{ Op19Slow },    { Op1ASlow },    { Op1B },        { Op1CSlow },    { Op1DSlow },
+	{ Op19Slow },    { Op1ASlow },    { Op1BSlow },    { Op1CSlow },    { Op1DSlow },
 	{ Op1ESlow },    { Op1FSlow },    { Op20Slow },    { Op21Slow },    { Op22Slow },
 	{ Op23Slow },    { Op24Slow },    { Op25Slow },    { Op26Slow },    { Op27Slow },
 	{ Op28Slow },    { Op29Slow },    { Op2ASlow },    { Op2BSlow },    { Op2CSlow },
@@ -3716,7 +3772,7 @@ struct SOpcodes S9xOpcodesSlow[256] =
 	{ Op87Slow },    { Op88Slow },    { Op89Slow },    { Op8ASlow },    { Op8BSlow },
 	{ Op8CSlow },    { Op8DSlow },    { Op8ESlow },    { Op8FSlow },    { Op90Slow },
 	{ Op91Slow },    { Op92Slow },    { Op93Slow },    { Op94Slow },    { Op95Slow },
-	{ Op96Slow },    { Op97Slow },    { Op98Slow },    { Op99Slow },    { Op9A },
+	{ Op96Slow },    { Op97Slow },    { Op98Slow },    { Op99Slow },    { Op9ASlow },
 	{ Op9BSlow },    { Op9CSlow },    { Op9DSlow },    { Op9ESlow },    { Op9FSlow },
 	{ OpA0Slow },    { OpA1Slow },    { OpA2Slow },    { OpA3Slow },    { OpA4Slow },
 	{ OpA5Slow },    { OpA6Slow },    { OpA7Slow },    { OpA8Slow },    { OpA9Slow },
@@ -1105,6 +1105,7 @@ bool8 S9xDoDMA (uint8 Channel)
 	if (CPU.NMIPending && (Timings.NMITriggerPos != 0xffff))
 	{
 		Timings.NMITriggerPos = CPU.Cycles + Timings.NMIDMADelay;
+		S9xScheduleInterruptCheck();
 	}
 
 	// Release the memory used in SPC7110 DMA
@@ -0,0 +1,741 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+// Scale2x by Andrea Mazzoleni, from AdvanceMAME (http://www.scale2x.it/).
+// xBR by Hyllian, level 1 rules. The colour correction ramp is the one
+// bsnes uses for its colour emulation.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snes9x.h"
+#include "filterpipe.h"
+
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+	#define FILTER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define FILTER_NEON 1
+#endif
+
+#ifdef FILTER_THREAD
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+namespace {
+
+	const uint16	Mask_2 = 0x07E0;	// 00000 111111 00000
+	const uint16	Mask13 = 0xF81F;	// 11111 000000 11111
+
+	uint16	*ColourLUT = NULL;	// RGB565 to corrected RGB565
+	uint32	*YUV = NULL;		// RGB565 to Y << 16 | U << 8 | V, for xBR
+
+	const uint8	gammaRamp[32] =
+	{
+		0x00, 0x01, 0x03, 0x06, 0x0a, 0x0f, 0x15, 0x1c,
+		0x24, 0x2d, 0x37, 0x42, 0x4e, 0x5b, 0x69, 0x78,
+		0x88, 0x90, 0x98, 0xa0, 0xa8, 0xb0, 0xb8, 0xc0,
+		0xc8, 0xd0, 0xd8, 0xe0, 0xe8, 0xf0, 0xf8, 0xff
+	};
+
+	// 6/8 of each channel, as the TV mode has always darkened its odd lines
+	alwaysinline uint16 Darken (uint16 p)
+	{
+		uint32	pi;
+
+		pi = (((p & Mask_2) * 6) >> 3) & Mask_2;
+		pi |= (((p & Mask13) * 6) >> 3) & Mask13;
+
+		return (pi);
+	}
+
+	// 3/4 of each channel
+	alwaysinline uint16 Dim (uint16 p)
+	{
+		return (p - ((p >> 2) & 0x39e7));
+	}
+
+	alwaysinline uint16 Average (uint16 a, uint16 b)
+	{
+		return ((a & b) + (((a ^ b) & 0xf7de) >> 1));
+	}
+
+	alwaysinline uint16 *Row (uint8 *base, uint32 pitch, int y)
+	{
+		return ((uint16 *) (base + y * pitch));
+	}
+
+	// Neighbouring row, clamped to the image
+	alwaysinline uint16 *Row (uint8 *base, uint32 pitch, int y, int height)
+	{
+		return (Row(base, pitch, y < 0 ? 0 : y >= height ? height - 1 : y));
+	}
+
+	alwaysinline int Clamp (int x, int width)
+	{
+		return (x < 0 ? 0 : x >= width ? width - 1 : x);
+	}
+
+#if defined(FILTER_SSE2) || defined(FILTER_NEON)
+
+	#define FILTER_SIMD 1
+
+	// Eight pixels per step. The conversions with per channel arithmetic
+	// split the channels so nothing carries between them, and give the same
+	// results as the scalar versions above.
+
+	#if defined(FILTER_SSE2)
+	typedef __m128i		v16;
+
+	alwaysinline v16 VSet (uint16 a)				{ return _mm_set1_epi16(a); }
+	alwaysinline v16 VLoad (const uint16 *p)		{ return _mm_loadu_si128((const __m128i *) p); }
+	alwaysinline void VStore (uint16 *p, v16 a)		{ _mm_storeu_si128((__m128i *) p, a); }
+	alwaysinline v16 VAnd (v16 a, v16 b)			{ return _mm_and_si128(a, b); }
+	alwaysinline v16 VAndNot (v16 a, v16 b)			{ return _mm_andnot_si128(b, a); }
+	alwaysinline v16 VOr (v16 a, v16 b)				{ return _mm_or_si128(a, b); }
+	alwaysinline v16 VXor (v16 a, v16 b)			{ return _mm_xor_si128(a, b); }
+	alwaysinline v16 VAdd (v16 a, v16 b)			{ return _mm_add_epi16(a, b); }
+	alwaysinline v16 VSub (v16 a, v16 b)			{ return _mm_sub_epi16(a, b); }
+	alwaysinline v16 VEq (v16 a, v16 b)				{ return _mm_cmpeq_epi16(a, b); }
+	alwaysinline v16 VSel (v16 m, v16 a, v16 b)		{ return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+	template<int n> alwaysinline v16 VShr (v16 a)	{ return _mm_srli_epi16(a, n); }
+	template<int n> alwaysinline v16 VShl (v16 a)	{ return _mm_slli_epi16(a, n); }
+
+	// a0 b0 a1 b1 ... a7 b7
+	alwaysinline void VStoreZip (uint16 *p, v16 a, v16 b)
+	{
+		_mm_storeu_si128((__m128i *) p,       _mm_unpacklo_epi16(a, b));
+		_mm_storeu_si128((__m128i *) (p + 8), _mm_unpackhi_epi16(a, b));
+	}
+	#else
+	typedef uint16x8_t	v16;
+
+	alwaysinline v16 VSet (uint16 a)				{ return vdupq_n_u16(a); }
+	alwaysinline v16 VLoad (const uint16 *p)		{ return vld1q_u16(p); }
+	alwaysinline void VStore (uint16 *p, v16 a)		{ vst1q_u16(p, a); }
+	alwaysinline v16 VAnd (v16 a, v16 b)			{ return vandq_u16(a, b); }
+	alwaysinline v16 VAndNot (v16 a, v16 b)			{ return vbicq_u16(a, b); }
+	alwaysinline v16 VOr (v16 a, v16 b)				{ return vorrq_u16(a, b); }
+	alwaysinline v16 VXor (v16 a, v16 b)			{ return veorq_u16(a, b); }
+	alwaysinline v16 VAdd (v16 a, v16 b)			{ return vaddq_u16(a, b); }
+	alwaysinline v16 VSub (v16 a, v16 b)			{ return vsubq_u16(a, b); }
+	alwaysinline v16 VEq (v16 a, v16 b)				{ return vceqq_u16(a, b); }
+	alwaysinline v16 VSel (v16 m, v16 a, v16 b)		{ return vbslq_u16(m, a, b); }
+	template<int n> alwaysinline v16 VShr (v16 a)	{ return vshrq_n_u16(a, n); }
+	template<int n> alwaysinline v16 VShl (v16 a)	{ return vshlq_n_u16(a, n); }
+
+	alwaysinline void VStoreZip (uint16 *p, v16 a, v16 b)
+	{
+		uint16x8x2_t	ab = { { a, b } };
+		vst2q_u16(p, ab);
+	}
+	#endif
+
+	// c * 6 >> 3 == c * 3 >> 2 for each channel on its own
+	alwaysinline v16 VDarken (v16 p)
+	{
+		v16	r = VShr<11>(p);
+		v16	g = VAnd(VShr<5>(p), VSet(0x3f));
+		v16	b = VAnd(p, VSet(0x1f));
+
+		r = VShr<2>(VAdd(r, VShl<1>(r)));
+		g = VShr<2>(VAdd(g, VShl<1>(g)));
+		b = VShr<2>(VAdd(b, VShl<1>(b)));
+
+		return (VOr(VOr(VShl<11>(r), VShl<5>(g)), b));
+	}
+
+	alwaysinline v16 VDim (v16 p)
+	{
+		return (VSub(p, VAnd(VShr<2>(p), VSet(0x39e7))));
+	}
+
+	alwaysinline v16 VAverage (v16 a, v16 b)
+	{
+		return (VAdd(VAnd(a, b), VShr<1>(VAnd(VXor(a, b), VSet(0xf7de)))));
+	}
+
+#endif
+
+	template<bool simd>
+	void RenderNearest2x (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*p  = Row(srcPtr, srcPitch, y);
+			uint16	*q0 = Row(dstPtr, dstPitch, y * 2);
+			uint16	*q1 = Row(dstPtr, dstPitch, y * 2 + 1);
+			int		i = 0;
+
+		#ifdef FILTER_SIMD
+			if (simd)
+			{
+				for (; i + 8 <= width; i += 8)
+				{
+					v16	E = VLoad(p + i);
+
+					VStoreZip(q0 + i * 2, E, E);
+					VStoreZip(q1 + i * 2, E, E);
+				}
+			}
+		#endif
+
+			for (; i < width; i++)
+				q0[i * 2] = q0[i * 2 + 1] = q1[i * 2] = q1[i * 2 + 1] = p[i];
+		}
+	}
+
+	alwaysinline void Scale2xPixel (uint16 *p, uint16 *pb, uint16 *ph, uint16 *q0, uint16 *q1, int i, int width)
+	{
+		uint16	B = pb[i];
+		uint16	D = p[Clamp(i - 1, width)];
+		uint16	E = p[i];
+		uint16	F = p[Clamp(i + 1, width)];
+		uint16	H = ph[i];
+
+		q0[i * 2]     = D == B && B != F && D != H ? D : E;
+		q0[i * 2 + 1] = B == F && B != D && F != H ? F : E;
+		q1[i * 2]     = D == H && D != B && H != F ? D : E;
+		q1[i * 2 + 1] = H == F && D != H && B != F ? F : E;
+	}
+
+	template<bool simd>
+	void RenderScale2x (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*p  = Row(srcPtr, srcPitch, y);
+			uint16	*pb = Row(srcPtr, srcPitch, y - 1, height);
+			uint16	*ph = Row(srcPtr, srcPitch, y + 1, height);
+			uint16	*q0 = Row(dstPtr, dstPitch, y * 2);
+			uint16	*q1 = Row(dstPtr, dstPitch, y * 2 + 1);
+			int		i = 0;
+
+		#ifdef FILTER_SIMD
+			if (simd && width > 9)
+			{
+				// The first and last columns have a clamped neighbour
+				Scale2xPixel(p, pb, ph, q0, q1, i++, width);
+
+				for (; i + 8 < width; i += 8)
+				{
+					v16	B = VLoad(pb + i);
+					v16	D = VLoad(p + i - 1);
+					v16	E = VLoad(p + i);
+					v16	F = VLoad(p + i + 1);
+					v16	H = VLoad(ph + i);
+
+					v16	eqDB = VEq(D, B), eqBF = VEq(B, F), eqDH = VEq(D, H), eqHF = VEq(H, F);
+
+					v16	E0 = VSel(VAndNot(VAndNot(eqDB, eqBF), eqDH), D, E);
+					v16	E1 = VSel(VAndNot(VAndNot(eqBF, eqDB), eqHF), F, E);
+					v16	E2 = VSel(VAndNot(VAndNot(eqDH, eqDB), eqHF), D, E);
+					v16	E3 = VSel(VAndNot(VAndNot(eqHF, eqDH), eqBF), F, E);
+
+					VStoreZip(q0 + i * 2, E0, E1);
+					VStoreZip(q1 + i * 2, E2, E3);
+				}
+			}
+		#endif
+
+			for (; i < width; i++)
+				Scale2xPixel(p, pb, ph, q0, q1, i, width);
+		}
+	}
+
+	template<bool simd>
+	void RenderTVMode (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*p  = Row(srcPtr, srcPitch, y);
+			uint16	*q0 = Row(dstPtr, dstPitch, y * 2);
+			uint16	*q1 = Row(dstPtr, dstPitch, y * 2 + 1);
+			int		i = 0;
+
+		#ifdef FILTER_SIMD
+			if (simd)
+			{
+				for (; i + 8 <= width; i += 8)
+				{
+					v16	E = VLoad(p + i);
+					v16	P = VDarken(E);
+
+					VStoreZip(q0 + i * 2, E, E);
+					VStoreZip(q1 + i * 2, P, P);
+				}
+			}
+		#endif
+
+			for (; i < width; i++)
+			{
+				uint16	pi = Darken(p[i]);
+
+				q0[i * 2] = q0[i * 2 + 1] = p[i];
+				q1[i * 2] = q1[i * 2 + 1] = pi;
+			}
+		}
+	}
+
+	// Every other line darkened; after nearest2x this is the TV mode
+	template<bool simd>
+	void RenderScanlines (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*p = Row(srcPtr, srcPitch, y);
+			uint16	*q = Row(dstPtr, dstPitch, y);
+			int		i = 0;
+
+			if (!(y & 1))
+			{
+				memcpy(q, p, width * sizeof(uint16));
+				continue;
+			}
+
+		#ifdef FILTER_SIMD
+			if (simd)
+			{
+				for (; i + 8 <= width; i += 8)
+					VStore(q + i, VDarken(VLoad(p + i)));
+			}
+		#endif
+
+			for (; i < width; i++)
+				q[i] = Darken(p[i]);
+		}
+	}
+
+	// Each pixel and its blend with the next one across, over a dimmed copy
+	template<bool simd>
+	void RenderCRT2x (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*p  = Row(srcPtr, srcPitch, y);
+			uint16	*q0 = Row(dstPtr, dstPitch, y * 2);
+			uint16	*q1 = Row(dstPtr, dstPitch, y * 2 + 1);
+			int		i = 0;
+
+		#ifdef FILTER_SIMD
+			if (simd)
+			{
+				for (; i + 8 < width; i += 8)
+				{
+					v16	E = VLoad(p + i);
+					v16	A = VAverage(E, VLoad(p + i + 1));
+
+					VStoreZip(q0 + i * 2, E, A);
+					VStoreZip(q1 + i * 2, VDim(E), VDim(A));
+				}
+			}
+		#endif
+
+			for (; i < width; i++)
+			{
+				uint16	E = p[i];
+				uint16	A = Average(E, p[Clamp(i + 1, width)]);
+
+				q0[i * 2] = E;
+				q0[i * 2 + 1] = A;
+				q1[i * 2] = Dim(E);
+				q1[i * 2 + 1] = Dim(A);
+			}
+		}
+	}
+
+	template<bool simd>
+	void RenderColour (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*p = Row(srcPtr, srcPitch, y);
+			uint16	*q = Row(dstPtr, dstPitch, y);
+
+			for (int i = 0; i < width; i++)
+				q[i] = ColourLUT[p[i]];
+		}
+	}
+
+	alwaysinline int Dist (uint16 a, uint16 b)
+	{
+		if (a == b)
+			return (0);
+
+		uint32	x = YUV[a], y = YUV[b];
+
+		return (48 * abs((int) (x >> 16) - (int) (y >> 16)) +
+				 7 * abs((int) ((x >> 8) & 0xff) - (int) ((y >> 8) & 0xff)) +
+				 6 * abs((int) (x & 0xff) - (int) (y & 0xff)));
+	}
+
+	// One output corner of E. P is the 5x5 neighbourhood, and dx, dy point
+	// at the corner: an edge along F-H, the two neighbours next to it, is
+	// rounded off by blending E with the closer of them.
+	alwaysinline uint16 XBRCorner (uint16 P[5][5], int dx, int dy)
+	{
+		#define PX(x, y)	P[2 + (y)][2 + (x)]
+
+		uint16	E = PX(0, 0), F = PX(dx, 0), H = PX(0, dy);
+
+		if (E == F || E == H)
+			return (E);
+
+		uint16	I = PX(dx, dy), B = PX(0, -dy), D = PX(-dx, 0), C = PX(dx, -dy), G = PX(-dx, dy);
+
+		int	e = Dist(E, C) + Dist(E, G) + Dist(I, PX(2 * dx, 0)) + Dist(I, PX(0, 2 * dy)) + 4 * Dist(H, F);
+		int	i = Dist(H, D) + Dist(H, PX(dx, 2 * dy)) + Dist(F, PX(2 * dx, dy)) + Dist(F, B) + 4 * Dist(E, I);
+
+		#undef PX
+
+		if (e >= i)
+			return (E);
+
+		return (Average(E, Dist(E, F) <= Dist(E, H) ? F : H));
+	}
+
+	template<bool simd>
+	void RenderXBR2x (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			uint16	*r[5];
+			uint16	*q0 = Row(dstPtr, dstPitch, y * 2);
+			uint16	*q1 = Row(dstPtr, dstPitch, y * 2 + 1);
+
+			for (int j = 0; j < 5; j++)
+				r[j] = Row(srcPtr, srcPitch, y + j - 2, height);
+
+			for (int i = 0; i < width; i++)
+			{
+				uint16	E = r[2][i];
+
+				// Flat areas are most of a frame
+				if (E == r[1][i] && E == r[3][i] && E == r[2][Clamp(i - 1, width)] && E == r[2][Clamp(i + 1, width)])
+				{
+					q0[i * 2] = q0[i * 2 + 1] = q1[i * 2] = q1[i * 2 + 1] = E;
+					continue;
+				}
+
+				uint16	P[5][5];
+
+				for (int j = 0; j < 5; j++)
+					for (int k = 0; k < 5; k++)
+						P[j][k] = r[j][Clamp(i + k - 2, width)];
+
+				q0[i * 2]     = XBRCorner(P, -1, -1);
+				q0[i * 2 + 1] = XBRCorner(P,  1, -1);
+				q1[i * 2]     = XBRCorner(P, -1,  1);
+				q1[i * 2 + 1] = XBRCorner(P,  1,  1);
+			}
+		}
+	}
+
+	bool8 BuildColourLUT (void)
+	{
+		if (ColourLUT)
+			return (TRUE);
+
+		if (!(ColourLUT = (uint16 *) malloc(0x10000 * sizeof(uint16))))
+			return (FALSE);
+
+		for (uint32 c = 0; c < 0x10000; c++)
+		{
+			uint8	r = gammaRamp[c >> 11], g = gammaRamp[(c >> 6) & 0x1f], b = gammaRamp[c & 0x1f];
+
+			ColourLUT[c] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+		}
+
+		return (TRUE);
+	}
+
+	bool8 BuildYUV (void)
+	{
+		if (YUV)
+			return (TRUE);
+
+		if (!(YUV = (uint32 *) malloc(0x10000 * sizeof(uint32))))
+			return (FALSE);
+
+		for (uint32 c = 0; c < 0x10000; c++)
+		{
+			int	r = c >> 11, g = (c >> 5) & 0x3f, b = c & 0x1f;
+
+			r = (r << 3) | (r >> 2);
+			g = (g << 2) | (g >> 4);
+			b = (b << 3) | (b >> 2);
+
+			int	Y = (r * 299 + g * 587 + b * 114) / 1000;
+			int	U = (b * 500 - r * 169 - g * 331) / 1000 + 128;
+			int	V = (r * 500 - g * 419 - b * 81) / 1000 + 128;
+
+			YUV[c] = (Y << 16) | (U << 8) | V;
+		}
+
+		return (TRUE);
+	}
+
+} // anonymous namespace
+
+const struct SFilterStage	FilterStages[NUM_FILTER_STAGES] =
+{
+	{ "nearest2x",  2,   2, RenderNearest2x<true>,  RenderNearest2x<false> },
+	{ "scale2x",    2,   4, RenderScale2x<true>,    RenderScale2x<false>   },
+	{ "tvmode",     2,   2, RenderTVMode<true>,     RenderTVMode<false>    },
+	{ "xbr2x",      2, 400, RenderXBR2x<true>,      RenderXBR2x<false>     },
+	{ "crt2x",      2,   2, RenderCRT2x<true>,      RenderCRT2x<false>     },
+	{ "scanlines",  1,   1, RenderScanlines<true>,  RenderScanlines<false> },
+	{ "colour",     1,   3, RenderColour<true>,     RenderColour<false>    }
+};
+
+#ifdef FILTER_THREAD
+// One worker per pipeline. Submit copies the frame so the emulation thread
+// can go on drawing the next one while the worker filters it; the
+// destination belongs to the worker until Wait returns.
+
+struct SFilterThread
+{
+	pthread_t	thread;
+	sem_t		start;
+	sem_t		done;
+	bool8		quit;
+	bool8		busy;
+	uint16		*In;
+	uint8		*dst;
+	uint32		dstPitch;
+	int			width;
+	int			height;
+};
+
+static void *S9xFilterThreadMain (void *arg)
+{
+	struct SFilterPipeline	*fp = (struct SFilterPipeline *) arg;
+	struct SFilterThread	*t = fp->Thread;
+
+	for (;;)
+	{
+		sem_wait(&t->start);
+		if (t->quit)
+			break;
+
+		S9xFilterPipelineRun(fp, (uint8 *) t->In, t->width * sizeof(uint16), t->dst, t->dstPitch, t->width, t->height);
+
+		sem_post(&t->done);
+	}
+
+	return (NULL);
+}
+
+bool8 S9xFilterPipelineStartThread (struct SFilterPipeline *fp)
+{
+	if (fp->Thread)
+		return (TRUE);
+
+	struct SFilterThread	*t = (struct SFilterThread *) calloc(1, sizeof(struct SFilterThread));
+	if (!t)
+		return (FALSE);
+
+	if (!(t->In = (uint16 *) malloc(MAX_SNES_WIDTH * MAX_SNES_HEIGHT * sizeof(uint16))))
+	{
+		free(t);
+		return (FALSE);
+	}
+
+	sem_init(&t->start, 0, 0);
+	sem_init(&t->done, 0, 0);
+	fp->Thread = t;
+
+	if (pthread_create(&t->thread, NULL, S9xFilterThreadMain, fp))
+	{
+		sem_destroy(&t->start);
+		sem_destroy(&t->done);
+		free(t->In);
+		free(t);
+		fp->Thread = NULL;
+		return (FALSE);
+	}
+
+	return (TRUE);
+}
+
+static void S9xFilterPipelineStopThread (struct SFilterPipeline *fp)
+{
+	struct SFilterThread	*t = fp->Thread;
+
+	if (!t)
+		return;
+
+	S9xFilterPipelineWait(fp);
+
+	t->quit = TRUE;
+	sem_post(&t->start);
+	pthread_join(t->thread, NULL);
+
+	sem_destroy(&t->start);
+	sem_destroy(&t->done);
+	free(t->In);
+	free(t);
+	fp->Thread = NULL;
+}
+
+void S9xFilterPipelineSubmit (struct SFilterPipeline *fp, uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+{
+	struct SFilterThread	*t = fp->Thread;
+
+	if (!t)
+	{
+		S9xFilterPipelineRun(fp, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	S9xFilterPipelineWait(fp);
+
+	for (int y = 0; y < height; y++)
+		memcpy(t->In + y * width, srcPtr + y * srcPitch, width * sizeof(uint16));
+
+	t->dst = dstPtr;
+	t->dstPitch = dstPitch;
+	t->width = width;
+	t->height = height;
+	t->busy = TRUE;
+
+	sem_post(&t->start);
+}
+
+void S9xFilterPipelineWait (struct SFilterPipeline *fp)
+{
+	struct SFilterThread	*t = fp->Thread;
+
+	if (t && t->busy)
+	{
+		sem_wait(&t->done);
+		t->busy = FALSE;
+	}
+}
+#endif
+
+int S9xFilterStageByName (const char *name)
+{
+	for (int s = 0; s < NUM_FILTER_STAGES; s++)
+	{
+		if (!strcasecmp(name, FilterStages[s].Name))
+			return (s);
+	}
+
+	return (-1);
+}
+
+bool8 S9xFilterPipelineInit (struct SFilterPipeline *fp, const uint8 *stages, int count)
+{
+	int	scale = 1, largest = 1;
+
+	memset(fp, 0, sizeof(struct SFilterPipeline));
+
+	if (count < 1 || count > FILTER_MAX_STAGES)
+		return (FALSE);
+
+	for (int s = 0; s < count; s++)
+	{
+		if (stages[s] >= NUM_FILTER_STAGES)
+			return (FALSE);
+
+		if ((scale *= FilterStages[stages[s]].Scale) > FILTER_MAX_SCALE)
+			return (FALSE);
+
+		if (s < count - 1 && scale > largest)
+			largest = scale;
+
+		if (stages[s] == FILTER_STAGE_COLOUR && !BuildColourLUT())
+			return (FALSE);
+
+		if (stages[s] == FILTER_STAGE_XBR2X && !BuildYUV())
+			return (FALSE);
+	}
+
+	// Stages take turns writing the two buffers; the last one writes the
+	// caller's destination
+	for (int b = 0; b < count - 1 && b < 2; b++)
+	{
+		fp->Buffer[b] = (uint16 *) malloc(MAX_SNES_WIDTH * largest * MAX_SNES_HEIGHT * largest * sizeof(uint16));
+		if (!fp->Buffer[b])
+		{
+			S9xFilterPipelineDeinit(fp);
+			return (FALSE);
+		}
+	}
+
+	memcpy(fp->Stages, stages, count);
+	fp->Count = count;
+
+	return (TRUE);
+}
+
+void S9xFilterPipelineDeinit (struct SFilterPipeline *fp)
+{
+#ifdef FILTER_THREAD
+	S9xFilterPipelineStopThread(fp);
+#endif
+
+	for (int b = 0; b < 2; b++)
+	{
+		free(fp->Buffer[b]);
+		fp->Buffer[b] = NULL;
+	}
+
+	fp->Count = 0;
+}
+
+int S9xFilterPipelineScale (const struct SFilterPipeline *fp)
+{
+	int	scale = 1;
+
+	for (int s = 0; s < fp->Count; s++)
+		scale *= FilterStages[fp->Stages[s]].Scale;
+
+	return (scale);
+}
+
+// Estimated cycles to filter a width x height frame
+uint32 S9xFilterPipelineCost (const struct SFilterPipeline *fp, int width, int height)
+{
+	uint32	cost = 0;
+
+	for (int s = 0; s < fp->Count; s++)
+	{
+		const struct SFilterStage	&stage = FilterStages[fp->Stages[s]];
+
+		cost += stage.Cost * width * height;
+		width *= stage.Scale;
+		height *= stage.Scale;
+	}
+
+	return (cost);
+}
+
+void S9xFilterPipelineRun (struct SFilterPipeline *fp, uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+{
+	for (int s = 0; s < fp->Count; s++)
+	{
+		const struct SFilterStage	&stage = FilterStages[fp->Stages[s]];
+		uint8						*out = dstPtr;
+		uint32						outPitch = dstPitch;
+
+		if (s < fp->Count - 1)
+		{
+			out = (uint8 *) fp->Buffer[s & 1];
+			outPitch = width * stage.Scale * sizeof(uint16);
+		}
+
+		stage.Run(srcPtr, srcPitch, out, outPitch, width, height);
+
+		srcPtr = out;
+		srcPitch = outPitch;
+		width *= stage.Scale;
+		height *= stage.Scale;
+	}
+}
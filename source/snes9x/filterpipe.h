@@ -0,0 +1,66 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifndef _FILTERPIPE_H_
+#define _FILTERPIPE_H_
+
+// Post-processing of finished RGB565 frames. A pipeline chains up to
+// FILTER_MAX_STAGES stages; each stage reads one image and writes another,
+// Scale times as large in both directions. Neighbouring pixels past the
+// edges are the edge pixels themselves, so no border is needed around the
+// source.
+
+enum
+{
+	FILTER_STAGE_NEAREST2X,
+	FILTER_STAGE_SCALE2X,
+	FILTER_STAGE_TVMODE,
+	FILTER_STAGE_XBR2X,
+	FILTER_STAGE_CRT2X,
+	FILTER_STAGE_SCANLINES,
+	FILTER_STAGE_COLOUR,
+	NUM_FILTER_STAGES
+};
+
+#define FILTER_MAX_STAGES	4
+#define FILTER_MAX_SCALE	4
+
+typedef void (*TFilterStageMethod) (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
+struct SFilterStage
+{
+	const char			*Name;
+	int					Scale;
+	uint32				Cost;		// estimated cycles per source pixel
+	TFilterStageMethod	Run;		// SIMD where the host has it
+	TFilterStageMethod	RunScalar;
+};
+
+struct SFilterThread;
+
+struct SFilterPipeline
+{
+	int						Count;
+	uint8					Stages[FILTER_MAX_STAGES];
+	uint16					*Buffer[2];		// between stages
+	struct SFilterThread	*Thread;		// FILTER_THREAD builds
+};
+
+extern const struct SFilterStage	FilterStages[NUM_FILTER_STAGES];
+
+bool8 S9xFilterPipelineInit (struct SFilterPipeline *, const uint8 *, int);
+void S9xFilterPipelineDeinit (struct SFilterPipeline *);
+int S9xFilterPipelineScale (const struct SFilterPipeline *);
+uint32 S9xFilterPipelineCost (const struct SFilterPipeline *, int, int);
+int S9xFilterStageByName (const char *);
+void S9xFilterPipelineRun (struct SFilterPipeline *, uint8 *, uint32, uint8 *, uint32, int, int);
+#ifdef FILTER_THREAD
+bool8 S9xFilterPipelineStartThread (struct SFilterPipeline *);
+void S9xFilterPipelineSubmit (struct SFilterPipeline *, uint8 *, uint32, uint8 *, uint32, int, int);
+void S9xFilterPipelineWait (struct SFilterPipeline *);
+#endif
+
+#endif
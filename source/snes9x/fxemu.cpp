@@ -8,6 +8,7 @@
 #include "memmap.h"
 #include "fxinst.h"
 #include "fxemu.h"
+#include "profiler.h"
 
 static void FxReset (struct FxInfo_s *);
 static void fx_readRegisterSpace (void);
@@ -29,7 +30,7 @@ void S9xResetSuperFX (void)
 {
 	// FIXME: Snes9x only runs the SuperFX at the end of every line.
 	// 5823405 is a magic number that seems to work for most games.
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 	SuperFX.speedPerLine = (uint32) (Settings.SuperFXSpeedPerLine * ((1.0f / Memory.ROMFramesPerSecond) / ((float) (Timings.V_Max)))); 
 	#else
 	SuperFX.speedPerLine = (uint32) (5823405 * ((1.0 / (float) Memory.ROMFramesPerSecond) / ((float) (Timings.V_Max)))); 
@@ -148,13 +149,18 @@ void S9xSuperFXExec (void)
 {
 	if ((Memory.FillRAM[0x3000 + GSU_SFR] & FLG_G) && (Memory.FillRAM[0x3000 + GSU_SCMR] & 0x18) == 0x18)
 	{
-		#ifdef GEKKO
+		PROFILE_ENTER(PROF_SUPERFX);
+		#if defined(GEKKO) || defined(HEADLESS)
 		FxEmulate(((Memory.FillRAM[0x3000 + GSU_CLSR] & 1) ? (SuperFX.speedPerLine * Timings.SuperFX2CoreSpeed) : SuperFX.speedPerLine) * Settings.SuperFXClockMultiplier / 100);
 		#endif
+		PROFILE_LEAVE();
 
 		uint16 GSUStatus = Memory.FillRAM[0x3000 + GSU_SFR] | (Memory.FillRAM[0x3000 + GSU_SFR + 1] << 8);
 		if ((GSUStatus & (FLG_G | FLG_IRQ)) == FLG_IRQ)
+		{
 			CPU.IRQExternal = TRUE;
+			S9xScheduleInterruptCheck();
+		}
 	}
 }
 
@@ -216,6 +222,8 @@ static void FxReset (struct FxInfo_s *psFxInfo)
 	// Start with a nop in the pipe
 	GSU.vPipe = 0x01;
 
+	fx_flushBlockCache();
+
 	// Set pointer to GSU cache
 	GSU.pvCache = &GSU.pvRegisters[0x100];
 
@@ -278,6 +286,10 @@ static void fx_readRegisterSpace (void)
 	GSU.pfPlot = fx_PlotTable[GSU.vMode];
 	GSU.pfRpix = fx_PlotTable[GSU.vMode + 5];
 
+	// Cached blocks hold the plot/rpix handlers they were decoded with
+	if (fx_OpcodeTable[0x04c] != GSU.pfPlot || fx_OpcodeTable[0x14c] != GSU.pfRpix)
+		fx_flushBlockCache();
+
 	fx_OpcodeTable[0x04c] = GSU.pfPlot;
 	fx_OpcodeTable[0x14c] = GSU.pfRpix;
 	fx_OpcodeTable[0x24c] = GSU.pfPlot;
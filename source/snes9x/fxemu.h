@@ -31,6 +31,7 @@ void S9xSuperFXExec (void);
 void S9xSetSuperFX (uint8, uint16);
 uint8 S9xGetSuperFX (uint16);
 void fx_flushCache (void);
+void fx_flushBlockCache (void);
 void fx_computeScreenPointers (void);
 uint32 fx_run (uint32);
 
@@ -393,6 +393,7 @@ static void fx_with_r15 (void)
 
 // 30-3b - stw (rn) - store word
 #define FX_STW(reg) \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = GSU.avReg[reg]; \
 	RAM(GSU.avReg[reg]) = (uint8) SREG; \
 	RAM(GSU.avReg[reg] ^ 1) = (uint8) (SREG >> 8); \
@@ -461,6 +462,7 @@ static void fx_stw_r11 (void)
 
 // 30-3b (ALT1) - stb (rn) - store byte
 #define FX_STB(reg) \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = GSU.avReg[reg]; \
 	RAM(GSU.avReg[reg]) = (uint8) SREG; \
 	CLRFLAGS; \
@@ -565,6 +567,7 @@ static void fx_alt3 (void)
 // 40-4b - ldw (rn) - load word from RAM
 #define FX_LDW(reg) \
 	uint32	v; \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = GSU.avReg[reg]; \
 	v = (uint32) RAM(GSU.avReg[reg]); \
 	v |= ((uint32) RAM(GSU.avReg[reg] ^ 1)) << 8; \
@@ -636,6 +639,7 @@ static void fx_ldw_r11 (void)
 // 40-4b (ALT1) - ldb (rn) - load byte
 #define FX_LDB(reg) \
 	uint32	v; \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = GSU.avReg[reg]; \
 	v = (uint32) RAM(GSU.avReg[reg]); \
 	R15++; \
@@ -703,72 +707,41 @@ static void fx_ldb_r11 (void)
 	FX_LDB(11);
 }
 
-// 4c - plot - plot pixel with R1, R2 as x, y and the color register as the color
-static void fx_plot_2bit (void)
+// The GSU's pixel cache. Plots to the same 8-pixel row of a character are
+// gathered in GSU.avPixelCacheData, one byte per bitplane, and written out
+// together when a plot lands in another row, so a horizontal span costs one
+// read-modify-write per bitplane every 8 pixels instead of one per pixel.
+// The real chip has a primary and a secondary cache so it can keep plotting
+// while a row is written out; that write is instant here, so one will do.
+// It is flushed before anything reads or writes GSU RAM (FLUSHPIXELS) and
+// when fx_run returns.
+void fx_flushPixelCache (void)
 {
-	uint32	x = USEX8(R1);
-	uint32	y = USEX8(R2);
-	uint8	*a;
-	uint8	v, c;
-
-	R15++;
-	CLRFLAGS;
-	R1++;
-
-#ifdef CHECK_LIMITS
-	if (y >= GSU.vScreenHeight)
-		return;
-#endif
+	uint8	*a = GSU.pvPixelCache;
+	uint8	m = (uint8) GSU.vPixelCacheMask;
 
-	if (!(GSU.vPlotOptionReg & 0x01) && !(COLR & 0xf))
-		return;
-
-	if (GSU.vPlotOptionReg & 0x02)
-		c = ((x ^ y) & 1) ? (uint8) (GSU.vColorReg >> 4) : (uint8) GSU.vColorReg;
-	else
-		c = (uint8) GSU.vColorReg;
-
-	a = GSU.apvScreen[y >> 3] + GSU.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
+	// Bitplanes are paired: 0 and 1 at a[0x00] and a[0x01], 2 and 3 at a[0x10]...
+	for (uint32 p = 0; p < GSU.vPixelCachePlanes; p += 2, a += 0x10)
+	{
+		uint32	d = GSU.avPixelCacheData[p >> 2] >> ((p & 2) << 3);
 
-	if (c & 0x01)
-		a[0] |=  v;
-	else
-		a[0] &= ~v;
+		a[0] = (a[0] & ~m) | ((uint8) d & m);
+		a[1] = (a[1] & ~m) | ((uint8) (d >> 8) & m);
+	}
 
-	if (c & 0x02)
-		a[1] |=  v;
-	else
-		a[1] &= ~v;
+	GSU.pvPixelCache = NULL;
+	GSU.vPixelCacheMask = 0;
 }
 
-// 4c (ALT1) - rpix - read color of the pixel with R1, R2 as x, y
-static void fx_rpix_2bit (void)
+// A byte of 0xff for each set bit of a color nibble
+static const uint32	fx_nibblePlanes[16] =
 {
-	uint32	x = USEX8(R1);
-	uint32	y = USEX8(R2);
-	uint8	*a;
-	uint8	v;
-
-	R15++;
-	CLRFLAGS;
-
-#ifdef CHECK_LIMITS
-	if (y >= GSU.vScreenHeight)
-		return;
-#endif
-
-	a = GSU.apvScreen[y >> 3] + GSU.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
-
-	DREG = 0;
-	DREG |= ((uint32) ((a[0] & v) != 0)) << 0;
-	DREG |= ((uint32) ((a[1] & v) != 0)) << 1;
-	TESTR14;
-}
+	0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff, 0x00ffff00, 0x00ffffff,
+	0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff, 0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff
+};
 
-// 4c - plot - plot pixel with R1, R2 as x, y and the color register as the color
-static void fx_plot_4bit (void)
+template <int planes>
+static inline void fx_plot (void)
 {
 	uint32	x = USEX8(R1);
 	uint32	y = USEX8(R2);
@@ -784,40 +757,49 @@ static void fx_plot_4bit (void)
 		return;
 #endif
 
-	if (!(GSU.vPlotOptionReg & 0x01) && !(COLR & 0xf))
-		return;
-
-	if (GSU.vPlotOptionReg & 0x02)
-		c = ((x ^ y) & 1) ? (uint8) (GSU.vColorReg >> 4) : (uint8) GSU.vColorReg;
-	else
+	if (planes == 8)
+	{
 		c = (uint8) GSU.vColorReg;
+		if (!(GSU.vPlotOptionReg & 0x10))
+		{
+			if (!(GSU.vPlotOptionReg & 0x01) && (!c || ((GSU.vPlotOptionReg & 0x08) && !(c & 0xf))))
+				return;
+		}
+		else
+		if (!(GSU.vPlotOptionReg & 0x01) && !c)
+			return;
+	}
+	else
+	{
+		if (!(GSU.vPlotOptionReg & 0x01) && !(COLR & 0xf))
+			return;
+
+		if (GSU.vPlotOptionReg & 0x02)
+			c = ((x ^ y) & 1) ? (uint8) (GSU.vColorReg >> 4) : (uint8) GSU.vColorReg;
+		else
+			c = (uint8) GSU.vColorReg;
+	}
 
 	a = GSU.apvScreen[y >> 3] + GSU.x[x >> 3] + ((y & 7) << 1);
 	v = 128 >> (x & 7);
 
-	if (c & 0x01)
-		a[0x00] |=  v;
-	else
-		a[0x00] &= ~v;
-
-	if (c & 0x02)
-		a[0x01] |=  v;
-	else
-		a[0x01] &= ~v;
+	if (a != GSU.pvPixelCache)
+	{
+		FLUSHPIXELS;
+		GSU.pvPixelCache = a;
+		GSU.vPixelCachePlanes = planes;
+	}
 
-	if (c & 0x04)
-		a[0x10] |=  v;
-	else
-		a[0x10] &= ~v;
+	uint32	m = v * 0x01010101;
 
-	if (c & 0x08)
-		a[0x11] |=  v;
-	else
-		a[0x11] &= ~v;
+	GSU.avPixelCacheData[0] = (GSU.avPixelCacheData[0] & ~m) | (fx_nibblePlanes[c & 0xf] & m);
+	if (planes == 8)
+		GSU.avPixelCacheData[1] = (GSU.avPixelCacheData[1] & ~m) | (fx_nibblePlanes[c >> 4] & m);
+	GSU.vPixelCacheMask |= v;
 }
 
-// 4c (ALT1) - rpix - read color of the pixel with R1, R2 as x, y
-static void fx_rpix_4bit (void)
+template <int planes>
+static inline void fx_rpix (void)
 {
 	uint32	x = USEX8(R1);
 	uint32	y = USEX8(R2);
@@ -832,118 +814,53 @@ static void fx_rpix_4bit (void)
 		return;
 #endif
 
+	FLUSHPIXELS;
+
 	a = GSU.apvScreen[y >> 3] + GSU.x[x >> 3] + ((y & 7) << 1);
 	v = 128 >> (x & 7);
 
 	DREG = 0;
-	DREG |= ((uint32) ((a[0x00] & v) != 0)) << 0;
-	DREG |= ((uint32) ((a[0x01] & v) != 0)) << 1;
-	DREG |= ((uint32) ((a[0x10] & v) != 0)) << 2;
-	DREG |= ((uint32) ((a[0x11] & v) != 0)) << 3;
+	for (int p = 0; p < planes; p++)
+		DREG |= ((uint32) ((a[((p >> 1) << 4) | (p & 1)] & v) != 0)) << p;
+	if (planes == 8)
+		GSU.vZero = DREG;
 	TESTR14;
 }
 
 // 4c - plot - plot pixel with R1, R2 as x, y and the color register as the color
-static void fx_plot_8bit (void)
+static void fx_plot_2bit (void)
 {
-	uint32	x = USEX8(R1);
-	uint32	y = USEX8(R2);
-	uint8	*a;
-	uint8	v, c;
-
-	R15++;
-	CLRFLAGS;
-	R1++;
-
-#ifdef CHECK_LIMITS
-	if (y >= GSU.vScreenHeight)
-		return;
-#endif
-
-	c = (uint8) GSU.vColorReg;
-	if (!(GSU.vPlotOptionReg & 0x10))
-	{
-		if (!(GSU.vPlotOptionReg & 0x01) && (!c || ((GSU.vPlotOptionReg & 0x08) && !(c & 0xf))))
-			return;
-	}
-	else
-	if (!(GSU.vPlotOptionReg & 0x01) && !c)
-		return;
-
-	a = GSU.apvScreen[y >> 3] + GSU.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
-
-	if (c & 0x01)
-		a[0x00] |=  v;
-	else
-		a[0x00] &= ~v;
-
-	if (c & 0x02)
-		a[0x01] |=  v;
-	else
-		a[0x01] &= ~v;
-
-	if (c & 0x04)
-		a[0x10] |=  v;
-	else
-		a[0x10] &= ~v;
-
-	if (c & 0x08)
-		a[0x11] |=  v;
-	else
-		a[0x11] &= ~v;
+	fx_plot<2>();
+}
 
-	if (c & 0x10)
-		a[0x20] |=  v;
-	else
-		a[0x20] &= ~v;
+// 4c (ALT1) - rpix - read color of the pixel with R1, R2 as x, y
+static void fx_rpix_2bit (void)
+{
+	fx_rpix<2>();
+}
 
-	if (c & 0x20)
-		a[0x21] |=  v;
-	else
-		a[0x21] &= ~v;
+// 4c - plot - plot pixel with R1, R2 as x, y and the color register as the color
+static void fx_plot_4bit (void)
+{
+	fx_plot<4>();
+}
 
-	if (c & 0x40)
-		a[0x30] |=  v;
-	else
-		a[0x30] &= ~v;
+// 4c (ALT1) - rpix - read color of the pixel with R1, R2 as x, y
+static void fx_rpix_4bit (void)
+{
+	fx_rpix<4>();
+}
 
-	if (c & 0x80)
-		a[0x31] |=  v;
-	else
-		a[0x31] &= ~v;
+// 4c - plot - plot pixel with R1, R2 as x, y and the color register as the color
+static void fx_plot_8bit (void)
+{
+	fx_plot<8>();
 }
 
 // 4c (ALT1) - rpix - read color of the pixel with R1, R2 as x, y
 static void fx_rpix_8bit (void)
 {
-	uint32	x = USEX8(R1);
-	uint32	y = USEX8(R2);
-	uint8	*a;
-	uint8	v;
-
-	R15++;
-	CLRFLAGS;
-
-#ifdef CHECK_LIMITS
-	if (y >= GSU.vScreenHeight)
-		return;
-#endif
-
-	a = GSU.apvScreen[y >> 3] + GSU.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
-
-	DREG = 0;
-	DREG |= ((uint32) ((a[0x00] & v) != 0)) << 0;
-	DREG |= ((uint32) ((a[0x01] & v) != 0)) << 1;
-	DREG |= ((uint32) ((a[0x10] & v) != 0)) << 2;
-	DREG |= ((uint32) ((a[0x11] & v) != 0)) << 3;
-	DREG |= ((uint32) ((a[0x20] & v) != 0)) << 4;
-	DREG |= ((uint32) ((a[0x21] & v) != 0)) << 5;
-	DREG |= ((uint32) ((a[0x30] & v) != 0)) << 6;
-	DREG |= ((uint32) ((a[0x31] & v) != 0)) << 7;
-	GSU.vZero = DREG;
-	TESTR14;
+	fx_rpix<8>();
 }
 
 // 4c - plot - plot pixel with R1, R2 as x, y and the color register as the color
@@ -2473,6 +2390,7 @@ static void fx_umult_i15 (void)
 // 90 - sbk - store word to last accessed RAM address
 static void fx_sbk (void)
 {
+	FLUSHPIXELS;
 	RAM(GSU.vLastRamAdr) = (uint8) SREG;
 	RAM(GSU.vLastRamAdr ^ 1) = (uint8) (SREG >> 8);
 	CLRFLAGS;
@@ -2772,6 +2690,7 @@ static void fx_ibt_r15 (void)
 
 // a0-af (ALT1) - lms rn, (yy) - load word from RAM (short address)
 #define FX_LMS(reg) \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = ((uint32) PIPE) << 1; \
 	R15++; \
 	FETCHPIPE; \
@@ -2865,6 +2784,7 @@ static void fx_lms_r15 (void)
 // XXX: If rn == r15, is the value of r15 before or after the extra byte is read ?
 #define FX_SMS(reg) \
 	uint32	v = GSU.avReg[reg]; \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = ((uint32) PIPE) << 1; \
 	R15++; \
 	FETCHPIPE; \
@@ -3774,6 +3694,7 @@ static void fx_iwt_r15 (void)
 
 // f0-ff (ALT1) - lm rn, (xx) - load word from RAM
 #define FX_LM(reg) \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = PIPE; \
 	R15++; \
 	FETCHPIPE; \
@@ -3870,6 +3791,7 @@ static void fx_lm_r15 (void)
 // XXX: If rn == r15, is the value of r15 before or after the extra bytes are read ?
 #define FX_SM(reg) \
 	uint32	v = GSU.avReg[reg]; \
+	FLUSHPIXELS; \
 	GSU.vLastRamAdr = PIPE; \
 	R15++; \
 	FETCHPIPE; \
@@ -3961,13 +3883,240 @@ static void fx_sm_r15 (void)
 	FX_SM(15);
 }
 
+// GSU block cache
+
+#ifdef FX_BLOCK_CACHE
+
+#define FX_BLOCK_CACHE_SIZE	1024	// entries, must be a power of two
+#define FX_BLOCK_MAX_OPS	32
+#define FX_STATE_FLAGS		(FLG_ALT1 | FLG_ALT2 | FLG_B)
+
+// One instruction, with the to/from/with/alt prefixes in front of it folded in
+struct SFxCachedOp
+{
+	void	(*Handler) (void);
+	uint32	*Sreg;		// set by the prefixes, or NULL
+	uint32	*Dreg;		// set by the prefixes, or NULL
+	uint32	Next;		// R15 after it when it falls through
+	uint16	Flags;		// ALT1/ALT2/B going into it
+	uint16	Steps;		// instructions from the start of the block up to it
+	uint8	Prefix;		// prefix instructions folded in
+	uint8	Pipe;		// byte following the opcode
+};
+
+// A run of straight-line code starting with the opcode in the pipe at
+// PBR:R15, decoded with the ALT1/ALT2/B state it was first reached in
+struct SFxCachedBlock
+{
+	uint32				Address;	// PBR:R15
+	uint32				Flags;
+	uint8				Op;			// opcode in the pipe
+	uint32				Count;		// 0 = can't be run from the cache
+	struct SFxCachedOp	Ops[FX_BLOCK_MAX_OPS];
+};
+
+static struct SFxCachedBlock	FxBlockCache[FX_BLOCK_CACHE_SIZE];
+
+void fx_flushBlockCache (void)
+{
+	for (int i = 0; i < FX_BLOCK_CACHE_SIZE; i++)
+		FxBlockCache[i].Address = 0xffffffff;
+}
+
+// Instruction length in bytes, the same in every ALT mode
+static inline uint32 fx_opLength (uint8 op)
+{
+	if ((op & 0xf0) == 0xf0)		// iwt, lm, sm
+		return (3);
+
+	if ((op & 0xf0) == 0xa0 || (op >= 0x05 && op <= 0x0f))	// ibt, lms, sms, branches
+		return (2);
+
+	return (1);
+}
+
+// stop, branches, loop and jmp/ljmp end a block
+static inline bool8 fx_endsBlock (uint8 op)
+{
+	return (op == 0x00 || (op >= 0x05 && op <= 0x0f) || op == 0x3c || (op >= 0x98 && op <= 0x9d));
+}
+
+// Follows the ALT1/ALT2/B flags through the block as the handlers would:
+// alt1-3 set ALT bits and clear B, with sets B, to and from without B only
+// pick registers, and every other instruction clears all three. Code in the
+// RAM banks can be rewritten by the GSU itself, so only ROM is cached and
+// nothing on the store path has to invalidate entries.
+static void fx_compileBlock (struct SFxCachedBlock *Block, uint32 address, uint32 flags)
+{
+	uint32	pc = R15;
+	uint8	op = PIPE;
+	uint32	prefix = 0, steps = 0;
+	uint32	*sreg = NULL, *dreg = NULL;
+
+	Block->Address = address;
+	Block->Flags = flags;
+	Block->Op = op;
+	Block->Count = 0;
+
+	if ((USEX8(PBR) & 0xfc) == 0x70)
+		return;
+
+	while (Block->Count < FX_BLOCK_MAX_OPS)
+	{
+		uint32	length = fx_opLength(op);
+
+		// Stay clear of the end of the bank, where R15 wraps
+		if (pc + length > 0xffff || prefix >= 8)
+			break;
+
+		if (op >= 0x3d && op <= 0x3f)
+			flags = (flags | ((op - 0x3c) << 8)) & ~FLG_B;
+		else
+		if ((op & 0xf0) == 0x20)
+		{
+			flags |= FLG_B;
+			sreg = dreg = &GSU.avReg[op & 0xf];
+		}
+		else
+		if ((op & 0xf0) == 0x10 && !(flags & FLG_B))
+			dreg = &GSU.avReg[op & 0xf];
+		else
+		if ((op & 0xf0) == 0xb0 && !(flags & FLG_B))
+			sreg = &GSU.avReg[op & 0xf];
+		else
+		{
+			struct SFxCachedOp	*Op = &Block->Ops[Block->Count++];
+
+			Op->Handler = fx_OpcodeTable[(flags & 0x300) | op];
+			Op->Sreg = sreg;
+			Op->Dreg = dreg;
+			Op->Next = pc + length;
+			Op->Flags = flags;
+			steps += prefix + 1;
+			Op->Steps = steps;
+			Op->Prefix = prefix;
+			Op->Pipe = PRGBANK(pc);
+
+			if (fx_endsBlock(op))
+				break;
+
+			pc += length;
+			op = PRGBANK(pc - 1);
+			flags = 0;
+			prefix = 0;
+			sreg = dreg = NULL;
+			continue;
+		}
+
+		prefix++;
+		op = PRGBANK(pc);
+		pc++;
+	}
+}
+
+static inline void fx_runCachedOp (struct SFxCachedOp *Op)
+{
+	if (Op->Prefix)
+	{
+		SFR = (SFR & ~FX_STATE_FLAGS) | Op->Flags;
+		if (Op->Sreg)
+			GSU.pvSreg = Op->Sreg;
+		if (Op->Dreg)
+			GSU.pvDreg = Op->Dreg;
+		R15 += Op->Prefix;
+	}
+
+	PIPE = Op->Pipe;
+	(*Op->Handler)();
+}
+
+// Runs the cached block for the opcode in the pipe, if there is one. Each
+// instruction does exactly what FX_STEP would, the prefixes folded into it
+// included, and counts towards vCounter the same. The block is left as soon
+// as R15 leaves it or vCounter runs out. Blocks are flushed on reset, when
+// cheats patch ROM and when the plot/rpix handlers change with the screen
+// mode.
+static bool8 fx_runCachedBlock (void)
+{
+	if (R15 > 0xffff)
+		return (FALSE);
+
+	uint32					address = (PBR << 16) | R15;
+	uint32					flags = SFR & FX_STATE_FLAGS;
+	struct SFxCachedBlock	*Block = &FxBlockCache[(address ^ (address >> 10)) & (FX_BLOCK_CACHE_SIZE - 1)];
+
+	if (Block->Address != address || Block->Flags != flags || Block->Op != PIPE)
+		fx_compileBlock(Block, address, flags);
+
+	if (!Block->Count)
+		return (FALSE);
+
+	struct SFxCachedOp	*Op = Block->Ops, *Last = Op + Block->Count - 1;
+
+	// Enough instructions left for the whole block, so vCounter is only
+	// brought up to date on the way out. fx_stop clears G and vCounter
+	// itself.
+	if (GSU.vCounter >= Last->Steps)
+	{
+		for (;; Op++)
+		{
+			fx_runCachedOp(Op);
+
+			if (Op == Last || R15 != Op->Next)
+				break;
+		}
+
+		if (TF(G))
+			GSU.vCounter -= Op->Steps;
+
+		return (TRUE);
+	}
+
+	for (;; Op++)
+	{
+		if (GSU.vCounter <= Op->Prefix)
+			return (Op != Block->Ops);
+
+		GSU.vCounter -= 1 + Op->Prefix;
+		fx_runCachedOp(Op);
+
+		if (Op == Last || R15 != Op->Next)
+			return (TRUE);
+	}
+}
+
+#else
+
+void fx_flushBlockCache (void)
+{
+}
+
+#endif
+
 // GSU executions functions
 
 uint32 fx_run (uint32 nInstructions)
 {
 	GSU.vCounter = nInstructions;
+#ifdef FX_BLOCK_CACHE
+	while (TF(G) && GSU.vCounter > 0)
+	{
+		if (!fx_runCachedBlock())
+		{
+			GSU.vCounter--;
+			FX_STEP;
+		}
+	}
+
+	// Leave vCounter where the loop below would
+	if (TF(G))
+		GSU.vCounter--;
+#else
 	while (TF(G) && (GSU.vCounter-- > 0))
 		FX_STEP;
+#endif
+
+	FLUSHPIXELS;
 #if 0
 #ifndef FX_ADDRESS_CHECK
 	GSU.vPipeAdr = USEX16(R15 - 1) | (USEX8(GSU.vPrgBankReg) << 16);
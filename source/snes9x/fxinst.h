@@ -134,6 +134,12 @@
 // Address checking (definately slow)
 //#define FX_ADDRESS_CHECK
 
+// Pre-decoded block cache for ROM-resident GSU code, see fx_runCachedBlock().
+// Left out of debugger builds like the 65c816 one.
+#if !defined(DEBUGGER) && !defined(NO_FX_BLOCK_CACHE)
+#define FX_BLOCK_CACHE
+#endif
+
 struct FxRegs_s
 {
 	// FxChip registers
@@ -184,6 +190,10 @@ struct FxRegs_s
 	uint32	vScreenSize;
 	void	(*pfPlot) (void);
 	void	(*pfRpix) (void);
+	uint8	*pvPixelCache;				// Screen address the pending plots go to, NULL if none
+	uint32	avPixelCacheData[2];		// Their bitplanes 0-3 and 4-7, one byte each
+	uint32	vPixelCacheMask;			// Pixels plotted, bit 7 is the leftmost
+	uint32	vPixelCachePlanes;			// 2, 4 or 8
 
 	uint8	*pvRamBank;					// Pointer to current RAM-bank
 	uint8	*pvRomBank;					// Pointer to current ROM-bank
@@ -299,6 +309,10 @@ extern struct FxRegs_s	GSU;
 // ABS
 #define ABS(x)			((x) < 0 ? -(x) : (x))
 
+// Write out pending plots before GSU RAM is read or written, so it always
+// looks as if every plot went straight to RAM
+#define FLUSHPIXELS		if (GSU.pvPixelCache) fx_flushPixelCache()
+
 // Access source register
 #define SREG			(*GSU.pvSreg)
 
@@ -315,8 +329,8 @@ extern struct FxRegs_s	GSU;
 
 #else
 
-// Read R14
-#define READR14			GSU.vRomBuffer = ROM(R14)
+// Read R14 (the ROM bank can be one of the RAM banks)
+#define READR14			{ if ((ROMBR & 0x7c) == 0x70) FLUSHPIXELS; GSU.vRomBuffer = ROM(R14); }
 
 // Test and/or read R14
 #define TESTR14			if (GSU.pvDreg == &R14) READR14
@@ -362,6 +376,8 @@ extern struct FxRegs_s	GSU;
 	(*fx_OpcodeTable[(GSU.vStatusReg & 0x300) | vOpcode])(); \
 }
 
+void fx_flushPixelCache (void);
+
 extern void (*fx_PlotTable[]) (void);
 extern void (*fx_OpcodeTable[]) (void);
 
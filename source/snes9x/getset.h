@@ -157,7 +157,8 @@ inline uint8 S9xGetByte (uint32 Address)
 	}
 }
 
-inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
+template <enum s9xwrap_t w>
+inline uint16 S9xGetWord (uint32 Address)
 {
 	uint16	word;
 
@@ -317,6 +318,23 @@ inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
 	}
 }
 
+// Wrap mode as a run-time argument, for callers where it isn't a constant
+inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
+{
+	switch (w)
+	{
+		case WRAP_PAGE:
+			return (S9xGetWord<WRAP_PAGE>(Address));
+
+		case WRAP_BANK:
+			return (S9xGetWord<WRAP_BANK>(Address));
+
+		case WRAP_NONE:
+		default:
+			return (S9xGetWord<WRAP_NONE>(Address));
+	}
+}
+
 inline void S9xSetByte (uint8 Byte, uint32 Address)
 {
 	int		block = (Address & 0xffffff) >> MEMMAP_SHIFT;
@@ -423,7 +441,8 @@ inline void S9xSetByte (uint8 Byte, uint32 Address)
 	}
 }
 
-inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NONE, enum s9xwriteorder_t o = WRITE_01)
+template <enum s9xwrap_t w, enum s9xwriteorder_t o>
+inline void S9xSetWord (uint16 Word, uint32 Address)
 {
 	uint32	mask = MEMMAP_MASK & (w == WRAP_PAGE ? 0xff : (w == WRAP_BANK ? 0xffff : 0xffffff));
 	if ((Address & mask) == mask)
@@ -694,6 +713,34 @@ inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NON
 	}
 }
 
+inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NONE, enum s9xwriteorder_t o = WRITE_01)
+{
+	switch (w)
+	{
+		case WRAP_PAGE:
+			if (o)
+				S9xSetWord<WRAP_PAGE, WRITE_10>(Word, Address);
+			else
+				S9xSetWord<WRAP_PAGE, WRITE_01>(Word, Address);
+			return;
+
+		case WRAP_BANK:
+			if (o)
+				S9xSetWord<WRAP_BANK, WRITE_10>(Word, Address);
+			else
+				S9xSetWord<WRAP_BANK, WRITE_01>(Word, Address);
+			return;
+
+		case WRAP_NONE:
+		default:
+			if (o)
+				S9xSetWord<WRAP_NONE, WRITE_10>(Word, Address);
+			else
+				S9xSetWord<WRAP_NONE, WRITE_01>(Word, Address);
+			return;
+	}
+}
+
 inline void S9xSetPCBase (uint32 Address)
 {
 	Registers.PBPC = Address & 0xffffff;
@@ -14,6 +14,14 @@
 #include "screenshot.h"
 #include "font.h"
 #include "display.h"
+#include "profiler.h"
+
+#ifdef RENDER_THREADS
+#include <stddef.h>
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+#endif
 
 extern struct SCheatData		Cheat;
 extern struct SLineData			LineData[240];
@@ -25,6 +33,7 @@ static int	font_width = 8, font_height = 9;
 void (*S9xCustomDisplayString) (const char *, int, int, bool, int) = NULL;
 
 static void SetupOBJ (void);
+static void SetupOBJRangeTimeOver (void);
 static void DrawOBJS (int);
 static void DisplayTime (void);
 static void DisplayFrameRate (void);
@@ -38,11 +47,190 @@ static void DrawBackgroundOffsetMosaic (int, uint8, uint8, int);
 static inline void DrawBackgroundMode7 (int, void (*DrawMath) (uint32, uint32, int), void (*DrawNomath) (uint32, uint32, int), int);
 static inline void DrawBackdrop (void);
 static inline void RenderScreen (bool8);
+static void RenderLines (bool8);
 static uint16 get_crosshair_color (uint8);
 static void S9xDisplayStringType (const char *, int, int, bool, int);
 
 #define TILE_PLUS(t, x)	(((t) & 0xfc00) | ((t + x) & 0x3ff))
 
+// What SetupOBJ needs to redo only part of GFX.OBJLines next time
+static struct
+{
+	bool8	Valid;							// last setup was a normal case one
+	bool8	Stale;							// GFX.OBJLines skipped over since then
+	int32	Limit;							// Settings.MaxSpriteTilesPerLine it used
+	uint8	RTOFlags[SNES_HEIGHT_EXTENDED];	// range/time over of each line alone
+	struct
+	{
+		uint8	Y;							// first line
+		uint8	Lines;						// lines the sprite was put on, 0 if none
+	}	Extent[128];
+}	OBJSetup;
+
+static inline bool8 OBJSetupNeeded (void)
+{
+	return (IPPU.OBJChanged || (IPPU.OBJDirty[0] | IPPU.OBJDirty[1] | IPPU.OBJDirty[2] | IPPU.OBJDirty[3]));
+}
+
+#ifdef RENDER_THREADS
+// Band renderers. S9xUpdateScreen hands each worker a slice of
+// GFX.StartY..GFX.EndY, renders the last slice itself and waits for the
+// rest, so the PPU state all bands read is frozen for the duration.
+// Every scanline renders independently of its neighbours except under
+// mosaic, where a block repeats the first line of the range, so those
+// ranges stay on one thread. Ranges shorter than two bands are not split
+// either, and S9xUpdateScreen flushes on every mid-frame PPU write, so
+// games that change PPU registers every few lines gain little or nothing.
+
+#define RENDER_MIN_BAND_LINES	16
+#define RENDER_MAX_THREADS		7
+
+namespace render_thread
+{
+	struct Worker
+	{
+		pthread_t	thread;
+		sem_t		start;
+		uint32		StartY;
+		uint32		EndY;
+		bool8		sub;
+	};
+
+	static Worker				workers[RENDER_MAX_THREADS];
+	static int					count = 0;		// workers running
+	static int					requested = 0;	// Settings.RenderThreads they were started for
+	static sem_t				done;
+	static std::atomic<bool>	quit(false);
+	static struct SGFX			*gfx = NULL;	// the emulation thread's GFX
+	static struct SBG			*bg = NULL;		// and BG
+} // namespace render_thread
+
+static void *S9xRenderThreadMain (void *arg)
+{
+	using namespace render_thread;
+
+	Worker	*w = (Worker *) arg;
+
+	for (;;)
+	{
+		sem_wait(&w->start);
+		if (quit)
+			break;
+
+		// Only the OBJLines of our own band are read, the rest of the copy
+		// is a few hundred bytes. OBJLines is the last field of SGFX.
+		memcpy(&GFX, gfx, offsetof(struct SGFX, OBJLines));
+		memcpy(&GFX.OBJLines[w->StartY], &gfx->OBJLines[w->StartY], (w->EndY - w->StartY + 1) * sizeof(GFX.OBJLines[0]));
+		BG = *bg;
+
+		GFX.StartY = w->StartY;
+		GFX.EndY = w->EndY;
+		RenderLines(w->sub);
+
+		sem_post(&done);
+	}
+
+	return (NULL);
+}
+
+static void S9xRenderThreadStop (void)
+{
+	using namespace render_thread;
+
+	requested = 0;
+
+	if (!count)
+		return;
+
+	quit = true;
+	for (int i = 0; i < count; i++)
+		sem_post(&workers[i].start);
+
+	for (int i = 0; i < count; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+		sem_destroy(&workers[i].start);
+	}
+
+	sem_destroy(&done);
+	count = 0;
+}
+
+static void S9xRenderThreadStart (int threads)
+{
+	using namespace render_thread;
+
+	requested = threads;
+
+	if (threads > RENDER_MAX_THREADS)
+		threads = RENDER_MAX_THREADS;
+
+	gfx = &GFX;
+	bg = &BG;
+	quit = false;
+	sem_init(&done, 0, 0);
+
+	for (count = 0; count < threads; count++)
+	{
+		sem_init(&workers[count].start, 0, 0);
+		if (pthread_create(&workers[count].thread, NULL, S9xRenderThreadMain, &workers[count]))
+		{
+			sem_destroy(&workers[count].start);
+			break;
+		}
+	}
+
+	// Whatever could be started is kept, and isn't retried until
+	// Settings.RenderThreads changes
+	if (!count)
+		sem_destroy(&done);
+}
+
+static void S9xRenderBands (bool8 sub)
+{
+	using namespace render_thread;
+
+	if (Settings.RenderThreads != requested)
+	{
+		S9xRenderThreadStop();
+		if (Settings.RenderThreads > 0)
+			S9xRenderThreadStart(Settings.RenderThreads);
+	}
+
+	uint32	lines = GFX.EndY - GFX.StartY + 1;
+	int		bands = lines / RENDER_MIN_BAND_LINES;
+
+	if (bands > count + 1)
+		bands = count + 1;
+
+	if (bands < 2 || (PPU.Mosaic > 1 && (PPU.BGMosaic[0] || PPU.BGMosaic[1] || PPU.BGMosaic[2] || PPU.BGMosaic[3])))
+	{
+		RenderLines(sub);
+		return;
+	}
+
+	uint32	StartY = GFX.StartY, EndY = GFX.EndY;
+	uint32	y = StartY;
+
+	for (int i = 0; i < bands - 1; i++)
+	{
+		workers[i].StartY = y;
+		workers[i].EndY = y + lines / bands - 1;
+		workers[i].sub = sub;
+		y = workers[i].EndY + 1;
+		sem_post(&workers[i].start);
+	}
+
+	GFX.StartY = y;
+	RenderLines(sub);
+	GFX.StartY = StartY;
+	GFX.EndY = EndY;
+
+	for (int i = 0; i < bands - 1; i++)
+		sem_wait(&done);
+}
+#endif
+
 
 bool8 S9xGraphicsInit (void)
 {
@@ -61,8 +249,9 @@ bool8 S9xGraphicsInit (void)
 	GFX.SubScreen  = (uint16 *) malloc(GFX.ScreenSize * sizeof(uint16));
 	GFX.ZBuffer    = (uint8 *)  malloc(GFX.ScreenSize);
 	GFX.SubZBuffer = (uint8 *)  malloc(GFX.ScreenSize);
+	GFX.MathBuffer = (uint8 *)  calloc(GFX.ScreenSize, 1);
 
-	if (!GFX.ZERO || !GFX.SubScreen || !GFX.ZBuffer || !GFX.SubZBuffer)
+	if (!GFX.ZERO || !GFX.SubScreen || !GFX.ZBuffer || !GFX.SubZBuffer || !GFX.MathBuffer)
 	{
 		S9xGraphicsDeinit();
 		return (FALSE);
@@ -105,10 +294,15 @@ bool8 S9xGraphicsInit (void)
 
 void S9xGraphicsDeinit (void)
 {
+#ifdef RENDER_THREADS
+	S9xRenderThreadStop();
+#endif
+
 	if (GFX.ZERO)       { free(GFX.ZERO);       GFX.ZERO       = NULL; }
 	if (GFX.SubScreen)  { free(GFX.SubScreen);  GFX.SubScreen  = NULL; }
 	if (GFX.ZBuffer)    { free(GFX.ZBuffer);    GFX.ZBuffer    = NULL; }
 	if (GFX.SubZBuffer) { free(GFX.SubZBuffer); GFX.SubZBuffer = NULL; }
+	if (GFX.MathBuffer) { free(GFX.MathBuffer); GFX.MathBuffer = NULL; }
 }
 
 void S9xGraphicsScreenResize (void)
@@ -232,7 +426,13 @@ void S9xEndScreenRefresh (void)
 			if (Settings.AutoDisplayMessages)
 				S9xDisplayMessages(GFX.Screen, GFX.RealPPL, IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight, 1);
 
+			if (GFX.PresentLines && GFX.PresentAll)
+				GFX.PresentLines(0, IPPU.RenderedScreenHeight - 1);
+			GFX.PresentAll = FALSE;
+
+			PROFILE_ENTER(PROF_FRONTEND);
 			S9xDeinitUpdate(IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight);
+			PROFILE_LEAVE();
 		}
 	}
 	else
@@ -277,6 +477,8 @@ void S9xEndScreenRefresh (void)
 
 void RenderLine (uint8 C)
 {
+	PROFILE_ENTER(PROF_PPU);
+
 	if (IPPU.RenderThisFrame)
 	{
 		LineData[C].BG[0].VOffset = PPU.BG[0].VOffset + 1;
@@ -310,10 +512,12 @@ void RenderLine (uint8 C)
 	{
 		// if we're not rendering this frame, we still need to update this
 		// XXX: Check ForceBlank? Or anything else?
-		if (IPPU.OBJChanged)
-			SetupOBJ();
+		if (OBJSetupNeeded())
+			SetupOBJRangeTimeOver();
 		PPU.RangeTimeOver |= GFX.OBJLines[C].RTOFlags;
 	}
+
+	PROFILE_LEAVE();
 }
 
 static inline void RenderScreen (bool8 sub)
@@ -442,11 +646,24 @@ static inline void RenderScreen (bool8 sub)
 	BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 0x20);
 
 	DrawBackdrop();
+
+	if (!sub && GFX.MathOp)
+		S9xComposeMath();
+}
+
+static void RenderLines (bool8 sub)
+{
+	if (sub)
+		RenderScreen(TRUE);
+
+	RenderScreen(FALSE);
 }
 
 void S9xUpdateScreen (void)
 {
-	if (IPPU.OBJChanged || IPPU.InterlaceOBJ)
+	PROFILE_ENTER(PROF_PPU);
+
+	if (OBJSetupNeeded() || OBJSetup.Stale || IPPU.InterlaceOBJ)
 		SetupOBJ();
 
 	// XXX: Check ForceBlank? Or anything else?
@@ -467,6 +684,8 @@ void S9xUpdateScreen (void)
 			PPU.RecomputeClipWindows = FALSE;
 		}
 
+		S9xUpdateTileCache();
+
 		if (Settings.SupportHiRes)
 		{
 			if (!IPPU.DoubleWidthPixels && (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires))
@@ -504,6 +723,7 @@ void S9xUpdateScreen (void)
 
 				IPPU.DoubleWidthPixels = TRUE;
 				IPPU.RenderedScreenWidth = 512;
+				GFX.PresentAll = TRUE;
 			}
 
 			if (!IPPU.DoubleHeightPixels && IPPU.Interlace && (PPU.BGMode == 5 || PPU.BGMode == 6))
@@ -515,19 +735,24 @@ void S9xUpdateScreen (void)
 
 				for (int32 y = (int32) GFX.StartY - 2; y >= 0; y--)
 					memmove(GFX.Screen + (y + 1) * GFX.PPL, GFX.Screen + y * GFX.RealPPL, GFX.PPL * sizeof(uint16));
+
+				GFX.PresentAll = TRUE;
 			}
 		}
 
 		if ((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2131] & 0x3f))
 			GFX.FixedColour = BUILD_PIXEL(IPPU.XB[PPU.FixedColourRed], IPPU.XB[PPU.FixedColourGreen], IPPU.XB[PPU.FixedColourBlue]);
 
-		if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires ||
-			((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2130] & 2) && (Memory.FillRAM[0x2131] & 0x3f) && (Memory.FillRAM[0x212d] & 0x1f)))
-			// If hires (Mode 5/6 or pseudo-hires) or math is to be done
-			// involving the subscreen, then we need to render the subscreen...
-			RenderScreen(TRUE);
+		// If hires (Mode 5/6 or pseudo-hires) or math is to be done
+		// involving the subscreen, then we need to render the subscreen...
+		bool8	sub = PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires ||
+			((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2130] & 2) && (Memory.FillRAM[0x2131] & 0x3f) && (Memory.FillRAM[0x212d] & 0x1f));
 
-		RenderScreen(FALSE);
+	#ifdef RENDER_THREADS
+		S9xRenderBands(sub);
+	#else
+		RenderLines(sub);
+	#endif
 	}
 	else
 	{
@@ -542,13 +767,29 @@ void S9xUpdateScreen (void)
 				GFX.S[x] = black;
 	}
 
+	// Hand the lines over while they are still in the cache, unless the
+	// whole frame has to be redone at the end anyway. With interlace only
+	// this field's rows were drawn.
+	if (GFX.PresentLines && !GFX.PresentAll)
+	{
+		if (GFX.PPL == GFX.RealPPL)
+			GFX.PresentLines(GFX.StartY, GFX.EndY);
+		else
+		{
+			uint32	field = (GFX.DoInterlace && GFX.InterlaceFrame) ? 1 : 0;
+
+			for (uint32 y = GFX.StartY; y <= GFX.EndY; y++)
+				GFX.PresentLines(y * 2 + field, y * 2 + field);
+		}
+	}
+
 	IPPU.PreviousLine = IPPU.CurrentLine;
+
+	PROFILE_LEAVE();
 }
 
-static void SetupOBJ (void)
+static void GetOBJSizes (int &SmallWidth, int &SmallHeight, int &LargeWidth, int &LargeHeight)
 {
-	int	SmallWidth, SmallHeight, LargeWidth, LargeHeight;
-
 	switch (PPU.OBJSizeSelect)
 	{
 		case 0:
@@ -592,6 +833,13 @@ static void SetupOBJ (void)
 			LargeWidth = LargeHeight = 32;
 			break;
 	}
+}
+
+static void SetupOBJ (void)
+{
+	int	SmallWidth, SmallHeight, LargeWidth, LargeHeight;
+
+	GetOBJSizes(SmallWidth, SmallHeight, LargeWidth, LargeHeight);
 
 	int	inc = IPPU.InterlaceOBJ ? 2 : 1;
 
@@ -607,22 +855,28 @@ static void SetupOBJ (void)
 
 	if (!PPU.OAMPriorityRotation || !(PPU.OAMFlip & PPU.OAMAddr & 1)) // normal case
 	{
-		uint8	LineOBJ[SNES_HEIGHT_EXTENDED];
-		memset(LineOBJ, 0, sizeof(LineOBJ));
+		// Only the lines a changed sprite was on or is on now are rebuilt,
+		// unless something that affects every sprite changed. OBJExtent
+		// remembers which lines each sprite was put on.
+		bool8	all = IPPU.OBJChanged || IPPU.InterlaceOBJ || !OBJSetup.Valid || OBJSetup.Stale || OBJSetup.Limit != Settings.MaxSpriteTilesPerLine;
+		bool8	Touched[SNES_HEIGHT_EXTENDED];
 
-		for (int i = 0; i < SNES_HEIGHT_EXTENDED; i++)
+		memset(Touched, all, sizeof(Touched));
+
+		for (S = 0; S < 128; S++)
 		{
-			GFX.OBJLines[i].RTOFlags = 0;
-			GFX.OBJLines[i].Tiles = Settings.MaxSpriteTilesPerLine;
-			for (int j = 0; j < sprite_limit; j++)
-				GFX.OBJLines[i].OBJ[j].Sprite = -1;
-		}
+			if (!all && !(IPPU.OBJDirty[S >> 5] & (1u << (S & 31))))
+				continue;
 
-		uint8	FirstSprite = PPU.FirstSprite;
-		S = FirstSprite;
+			for (int j = 0; j < OBJSetup.Extent[S].Lines; j++)
+			{
+				uint8	Y = OBJSetup.Extent[S].Y + j;
+				if (Y < SNES_HEIGHT_EXTENDED)
+					Touched[Y] = TRUE;
+			}
+
+			OBJSetup.Extent[S].Lines = 0;
 
-		do
-		{
 			if (PPU.OBJ[S].Size)
 			{
 				GFX.OBJWidths[S] = LargeWidth;
@@ -648,38 +902,79 @@ static void SetupOBJ (void)
 				else
 					GFX.OBJVisibleTiles[S] = GFX.OBJWidths[S] >> 3;
 
-				for (uint8 line = startline, Y = (uint8) (PPU.OBJ[S].VPos & 0xff); line < Height; Y++, line += inc)
+				OBJSetup.Extent[S].Y = PPU.OBJ[S].VPos & 0xff;
+				OBJSetup.Extent[S].Lines = (Height - startline + inc - 1) / inc;
+
+				for (int j = 0; j < OBJSetup.Extent[S].Lines; j++)
 				{
-					if (Y >= SNES_HEIGHT_EXTENDED)
-						continue;
+					uint8	Y = OBJSetup.Extent[S].Y + j;
+					if (Y < SNES_HEIGHT_EXTENDED)
+						Touched[Y] = TRUE;
+				}
+			}
+		}
 
-					if (LineOBJ[Y] >= sprite_limit)
-					{
-						GFX.OBJLines[Y].RTOFlags |= 0x40;
-						continue;
-					}
+		memset(IPPU.OBJDirty, 0, sizeof(IPPU.OBJDirty));
 
-					GFX.OBJLines[Y].Tiles -= GFX.OBJVisibleTiles[S];
-					if (GFX.OBJLines[Y].Tiles < 0)
-						GFX.OBJLines[Y].RTOFlags |= 0x80;
+		uint8	LineOBJ[SNES_HEIGHT_EXTENDED];
+		memset(LineOBJ, 0, sizeof(LineOBJ));
 
-					GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Sprite = S;
-					if (PPU.OBJ[S].VFlip)
-						// Yes, Width not Height. It so happens that the
-						// sprites with H=2*W flip as two WxW sprites.
-						GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Line = line ^ (GFX.OBJWidths[S] - 1);
-					else
-						GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Line = line;
+		for (int i = 0; i < SNES_HEIGHT_EXTENDED; i++)
+		{
+			if (Touched[i])
+			{
+				OBJSetup.RTOFlags[i] = 0;
+				GFX.OBJLines[i].Tiles = Settings.MaxSpriteTilesPerLine;
+			}
+		}
+
+		uint8	FirstSprite = PPU.FirstSprite;
+		S = FirstSprite;
 
-					LineOBJ[Y]++;
+		do
+		{
+			for (int j = 0; j < OBJSetup.Extent[S].Lines; j++)
+			{
+				uint8	Y = OBJSetup.Extent[S].Y + j;
+				if (Y >= SNES_HEIGHT_EXTENDED || !Touched[Y])
+					continue;
+
+				if (LineOBJ[Y] >= sprite_limit)
+				{
+					OBJSetup.RTOFlags[Y] |= 0x40;
+					continue;
 				}
+
+				GFX.OBJLines[Y].Tiles -= GFX.OBJVisibleTiles[S];
+				if (GFX.OBJLines[Y].Tiles < 0)
+					OBJSetup.RTOFlags[Y] |= 0x80;
+
+				uint8	line = startline + j * inc;
+
+				GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Sprite = S;
+				if (PPU.OBJ[S].VFlip)
+					// Yes, Width not Height. It so happens that the
+					// sprites with H=2*W flip as two WxW sprites.
+					GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Line = line ^ (GFX.OBJWidths[S] - 1);
+				else
+					GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Line = line;
+
+				LineOBJ[Y]++;
 			}
 
 			S = (S + 1) & 0x7f;
 		} while (S != FirstSprite);
 
-		for (int Y = 1; Y < SNES_HEIGHT_EXTENDED; Y++)
-			GFX.OBJLines[Y].RTOFlags |= GFX.OBJLines[Y - 1].RTOFlags;
+		for (int Y = 0; Y < SNES_HEIGHT_EXTENDED; Y++)
+		{
+			if (Touched[Y] && LineOBJ[Y] < sprite_limit)
+				GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Sprite = -1;
+
+			GFX.OBJLines[Y].RTOFlags = OBJSetup.RTOFlags[Y] | (Y ? GFX.OBJLines[Y - 1].RTOFlags : 0);
+		}
+
+		OBJSetup.Valid = TRUE;
+		OBJSetup.Limit = Settings.MaxSpriteTilesPerLine;
 	}
 	else // evil FirstSprite+Y case
 	{
@@ -777,8 +1072,125 @@ static void SetupOBJ (void)
 			if (j < sprite_limit)
 				GFX.OBJLines[Y].OBJ[j].Sprite = -1;
 		}
+
+		OBJSetup.Valid = FALSE;
+		memset(IPPU.OBJDirty, 0, sizeof(IPPU.OBJDirty));
 	}
 
+	OBJSetup.Stale = FALSE;
+	IPPU.OBJChanged = FALSE;
+}
+
+// Skipped frames only need GFX.OBJLines[].RTOFlags, for $213E. Count the
+// sprites and tiles on each line with difference arrays instead of filling
+// the per-line sprite lists, and only walk the sprites in priority order on
+// lines holding more than sprite_limit of them, where which ones count
+// matters. The lists are left as they were, so the next SetupOBJ redoes all.
+static void SetupOBJRangeTimeOver (void)
+{
+	int	SmallWidth, SmallHeight, LargeWidth, LargeHeight;
+
+	GetOBJSizes(SmallWidth, SmallHeight, LargeWidth, LargeHeight);
+
+	int	inc = IPPU.InterlaceOBJ ? 2 : 1;
+
+	int startline = (IPPU.InterlaceOBJ && GFX.InterlaceFrame) ? 1 : 0;
+
+	bool8	evil = PPU.OAMPriorityRotation && (PPU.OAMFlip & PPU.OAMAddr & 1);
+	int sprite_limit = (Settings.MaxSpriteTilesPerLine == 128) ? 128 : 32;
+
+	uint8	FirstY[128], Lines[128], Visible[128];
+	int		Count[SNES_HEIGHT_EXTENDED + 1], Tiles[SNES_HEIGHT_EXTENDED + 1];
+
+	memset(Count, 0, sizeof(Count));
+	memset(Tiles, 0, sizeof(Tiles));
+
+	for (int S = 0; S < 128; S++)
+	{
+		int	Width  = PPU.OBJ[S].Size ? LargeWidth  : SmallWidth;
+		int	Height = PPU.OBJ[S].Size ? LargeHeight : SmallHeight;
+
+		Lines[S] = 0;
+
+		// Same rules as SetupOBJ, which differ between its two cases
+		int	HPos = PPU.OBJ[S].HPos;
+		if (HPos == -256)
+			HPos = evil ? 256 : 0;
+
+		if (HPos <= -Width || HPos > 256)
+			continue;
+
+		if (HPos < 0)
+			Visible[S] = (Width + HPos + 7) >> 3;
+		else
+		if (HPos + Width > (evil ? 256 : 255))
+			Visible[S] = ((evil ? 257 : 256) - HPos + 7) >> 3;
+		else
+			Visible[S] = Width >> 3;
+
+		FirstY[S] = PPU.OBJ[S].VPos & 0xff;
+		Lines[S] = (Height - startline + inc - 1) / inc;
+
+		// The lines wrap at 256, so a sprite covers at most two runs
+		int	a = FirstY[S], b = a + Lines[S];
+
+		for (int run = 0; run < 2; run++, a -= 256, b -= 256)
+		{
+			int	lo = a < 0 ? 0 : a, hi = b > SNES_HEIGHT_EXTENDED ? SNES_HEIGHT_EXTENDED : b;
+			if (lo >= hi)
+				continue;
+
+			Count[lo]++;
+			Count[hi]--;
+			Tiles[lo] += Visible[S];
+			Tiles[hi] -= Visible[S];
+		}
+	}
+
+	int		c = 0, t = 0;
+	uint8	RTO = 0;
+
+	for (int Y = 0; Y < SNES_HEIGHT_EXTENDED; Y++)
+	{
+		c += Count[Y];
+		t += Tiles[Y];
+
+		if (c > sprite_limit)
+		{
+			uint8	FirstSprite = evil ? (PPU.FirstSprite + Y) & 0x7f : PPU.FirstSprite;
+			uint8	S = FirstSprite;
+			int		j = 0, n = 0;
+
+			do
+			{
+				if ((uint8) (Y - FirstY[S]) < Lines[S])
+				{
+					if (j >= sprite_limit)
+					{
+						RTO |= 0x40;
+						break;
+					}
+
+					n += Visible[S];
+					j++;
+				}
+
+				S = (S + 1) & 0x7f;
+			} while (S != FirstSprite);
+
+			if (n > Settings.MaxSpriteTilesPerLine)
+				RTO |= 0x80;
+		}
+		else
+		if (t > Settings.MaxSpriteTilesPerLine)
+			RTO |= 0x80;
+
+		GFX.OBJLines[Y].RTOFlags = RTO;
+	}
+
+	OBJSetup.Valid = FALSE;
+	OBJSetup.Stale = TRUE;
+	memset(IPPU.OBJDirty, 0, sizeof(IPPU.OBJDirty));
 	IPPU.OBJChanged = FALSE;
 }
 
@@ -1772,6 +2184,8 @@ void S9xDisplayChar (uint16 *s, uint8 c)
 {
 	const uint16	black = BUILD_PIXEL(0, 0, 0);
 
+	GFX.PresentAll = TRUE;
+
 	int	line   = ((c - 32) >> 4) * font_height;
 	int	offset = ((c - 32) & 15) * font_width;
 
@@ -1880,6 +2294,13 @@ static void DisplayFrameRate (void)
 #endif
 
 	S9xDisplayString(string, 1, IPPU.RenderedScreenWidth - (font_width - 1) * len - 1, false);
+
+#ifdef PROFILER
+	char	profile[64];
+
+	S9xProfilerSummary(profile, sizeof(profile), Memory.ROMFramesPerSecond);
+	S9xDisplayString(profile, 3, 1, false);
+#endif
 }
 
 static void DisplayPressedKeys (void)
@@ -2045,6 +2466,35 @@ static void DisplayWatchedAddresses (void)
 	}
 }
 
+// Lets S9xUpdateScreen write each band of lines into the host's texture as
+// soon as it is drawn, instead of the host copying the whole frame after
+// S9xDeinitUpdate. Only for layouts Screen cannot be pointed at directly.
+void S9xSetPresentTarget (int layout, uint16 *texture)
+{
+	GFX.PresentTexture = texture;
+	GFX.PresentLines = NULL;
+	GFX.PresentAll = FALSE;
+
+	if (texture && layout == PRESENT_TILED4X4)
+		GFX.PresentLines = S9xPresentTiled4x4;
+}
+
+// Rows first to last of Screen. A tile row holds four rows of the image,
+// and each row puts four pixels in every tile.
+void S9xPresentTiled4x4 (uint32 first, uint32 last)
+{
+	uint32	width = IPPU.RenderedScreenWidth;
+
+	for (uint32 y = first; y <= last; y++)
+	{
+		const uint16	*s = GFX.Screen + y * GFX.RealPPL;
+		uint16			*d = GFX.PresentTexture + (y >> 2) * width * 4 + (y & 3) * 4;
+
+		for (uint32 x = 0; x < width; x += 4, s += 4, d += 16)
+			memcpy(d, s, 4 * sizeof(uint16));
+	}
+}
+
 void S9xDisplayMessages (uint16 *screen, int ppl, int width, int height, int scale)
 {
 	if (Settings.DisplayTime)
@@ -2108,6 +2558,8 @@ void S9xDrawCrosshair (const char *crosshair, uint8 fgcolor, uint8 bgcolor, int1
 	fg = get_crosshair_color(fgcolor);
 	bg = get_crosshair_color(bgcolor);
 
+	GFX.PresentAll = TRUE;
+
 	uint16	*s = GFX.Screen + y * (int32)GFX.RealPPL + x;
 
 	for (r = 0; r < 15 * rx; r++, s += GFX.RealPPL - 15 * cx)
@@ -15,6 +15,7 @@ struct SGFX
 	uint16	*SubScreen;
 	uint8	*ZBuffer;
 	uint8	*SubZBuffer;
+	uint8	*MathBuffer;		// per-pixel colour math flags of the main screen, see S9xComposeMath
 	uint32	Pitch;
 	uint32	ScreenSize;
 	uint16	*S;
@@ -33,23 +34,12 @@ struct SGFX
 	uint32	StartY;
 	uint32	EndY;
 	bool8	ClipColors;
+	uint8	MathOp;				// blend left in MathBuffer by the main screen renderers, 0 if none
 	uint8	OBJWidths[128];
 	uint8	OBJVisibleTiles[128];
 
 	struct ClipData	*Clip;
 
-	struct
-	{
-		uint8	RTOFlags;
-		int16	Tiles;
-
-		struct
-		{
-			int8	Sprite;
-			uint8	Line;
-		}	OBJ[128];
-	}	OBJLines[SNES_HEIGHT_EXTENDED];
-
 	void	(*DrawBackdropMath) (uint32, uint32, uint32);
 	void	(*DrawBackdropNomath) (uint32, uint32, uint32);
 	void	(*DrawTileMath) (uint32, uint32, uint32, uint32);
@@ -66,6 +56,31 @@ struct SGFX
 	const char	*InfoString;
 	uint32	InfoStringTimeout;
 	char	FrameDisplayString[256];
+
+	uint16	*PresentTexture;	// host texture PresentLines writes into
+	void	(*PresentLines) (uint32, uint32);	// copies finished lines of Screen, NULL if the host reads Screen itself
+	bool8	PresentAll;			// Screen was written outside the renderers, redo it all before S9xDeinitUpdate
+
+	// Kept last: render workers copy everything before it and only their
+	// own band of it
+	struct
+	{
+		uint8	RTOFlags;
+		int16	Tiles;
+
+		struct
+		{
+			int8	Sprite;
+			uint8	Line;
+		}	OBJ[128];
+	}	OBJLines[SNES_HEIGHT_EXTENDED];
+};
+
+// Host texture layouts for S9xSetPresentTarget
+enum
+{
+	PRESENT_NONE,
+	PRESENT_TILED4X4		// GX: 4x4 pixel tiles of RGB565, left to right, then down
 };
 
 struct SBG
@@ -120,8 +135,25 @@ extern uint16		BlackColourMap[256];
 extern uint16		DirectColourMaps[8][256];
 extern uint8		mul_brightness[16][32];
 extern uint8		brightness_cap[64];
-extern struct SBG	BG;
-extern struct SGFX	GFX;
+// With RENDER_THREADS each band renderer works on its own copy of GFX and BG
+// (see S9xRenderBands); everything else only ever sees the emulation
+// thread's. Tile cache flags may then be set by several threads at once, so
+// they're published after the converted pixels, and the counters they bump
+// are added to atomically.
+#ifdef RENDER_THREADS
+#define GFX_THREAD_LOCAL			thread_local
+#define TILE_CACHED_GET(f)			__atomic_load_n(&(f), __ATOMIC_ACQUIRE)
+#define TILE_CACHED_SET(f, v)		__atomic_store_n(&(f), (v), __ATOMIC_RELEASE)
+#define TILE_STAT_INC(n)			__atomic_fetch_add(&(n), 1, __ATOMIC_RELAXED)
+#else
+#define GFX_THREAD_LOCAL
+#define TILE_CACHED_GET(f)			(f)
+#define TILE_CACHED_SET(f, v)		((f) = (v))
+#define TILE_STAT_INC(n)			((n)++)
+#endif
+
+extern GFX_THREAD_LOCAL struct SBG	BG;
+extern GFX_THREAD_LOCAL struct SGFX	GFX;
 
 #define H_FLIP		0x4000
 #define V_FLIP		0x8000
@@ -208,6 +240,8 @@ void S9xDisplayChar (uint16 *, uint8);
 void S9xGraphicsScreenResize (void);
 // called automatically unless Settings.AutoDisplayMessages is false
 void S9xDisplayMessages (uint16 *, int, int, int, int);
+void S9xSetPresentTarget (int, uint16 *);
+void S9xPresentTiled4x4 (uint32, uint32);
 
 // external port interface which must be implemented or initialised for each port
 bool8 S9xGraphicsInit (void);
@@ -27,8 +27,8 @@ struct SPPU				PPU;
 struct InternalPPU		IPPU;
 struct SDMA				DMA[8];
 struct STimings			Timings;
-struct SGFX				GFX;
-struct SBG				BG;
+GFX_THREAD_LOCAL struct SGFX	GFX;
+GFX_THREAD_LOCAL struct SBG		BG;
 struct SLineData		LineData[240];
 struct SLineMatrixData	LineMatrixData[240];
 struct SDSP0			DSP0;
@@ -6,6 +6,8 @@
 
 #ifdef GEKKO
 #include <gccore.h>
+#endif
+#if defined(GEKKO) || defined(HEADLESS)
 #include <malloc.h>
 #endif
 
@@ -2658,7 +2660,7 @@ void CMemory::InitROM (void)
 	Timings.NMIDMADelay  = 24;
 	Timings.IRQTriggerCycles = 14;
 	Timings.APUSpeedup = 0;
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 	Timings.APUAllowTimeOverflow = FALSE;
 	#endif
 	S9xAPUTimingSetSpeedup(Timings.APUSpeedup);
@@ -3184,7 +3186,7 @@ void CMemory::Map_SA1LoROMMap (void)
 
 	map_hirom_offset(0xc0, 0xff, 0x0000, 0xffff, CalculatedSize, 0);
 
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 	if (match_id("AZIJ"))                    { // Dragon Ball Z - Hyper Dimension (J)	
 		map_space(0x00, 0x3f, 0x3000, 0x3fff, FillRAM);
 		map_space(0x80, 0xbf, 0x3000, 0x3fff, FillRAM);
@@ -3199,7 +3201,7 @@ void CMemory::Map_SA1LoROMMap (void)
 	map_index(0x00, 0x3f, 0x6000, 0x7fff, MAP_BWRAM, MAP_TYPE_I_O);
 	map_index(0x80, 0xbf, 0x6000, 0x7fff, MAP_BWRAM, MAP_TYPE_I_O);
 
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 	if (match_id("AZIJ"))                    { // Dragon Ball Z - Hyper Dimension (J)	
 		for (int c = 0x40; c < 0x80; c++)
 			map_space(c, c, 0x0000, 0xffff, SRAM + (c & 1) * 0x10000);
@@ -3679,7 +3681,7 @@ void CMemory::ApplyROMFixes (void)
 		if (match_na("CIRCUIT USA"))
 			Timings.APUSpeedup = 3;
 
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 		if (match_na("GAIA GENSOUKI 1 JPN")                     || // Gaia Gensouki
 			match_id("JG  ")                                    || // Illusion of Gaia
 			match_id("CQ  ")                                    || // Stunt Race FX
@@ -3739,11 +3741,11 @@ void CMemory::ApplyROMFixes (void)
 	}
 
 	S9xAPUTimingSetSpeedup(Timings.APUSpeedup);
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 	S9xAPUAllowTimeOverflow(Timings.APUAllowTimeOverflow);
 	#endif
 	
-	#ifdef GEKKO
+	#if defined(GEKKO) || defined(HEADLESS)
 	if (match_id("YI  ")) { // Super Mario World 2 - Yoshi's Island 
 			Timings.SuperFX2CoreSpeed = 8 / 3;
 		}
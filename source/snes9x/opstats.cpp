@@ -0,0 +1,203 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifdef OPCODE_STATS
+
+#include <algorithm>
+#include "snes9x.h"
+#include "opstats.h"
+
+struct SOpcodeStats	OpcodeStats;
+
+enum
+{
+	OPMODE_IMPLIED,
+	OPMODE_ACCUMULATOR,
+	OPMODE_IMMEDIATE,
+	OPMODE_DIRECT,
+	OPMODE_DIRECT_X,
+	OPMODE_DIRECT_Y,
+	OPMODE_DIRECT_INDIRECT,
+	OPMODE_DIRECT_INDEXED_INDIRECT,
+	OPMODE_DIRECT_INDIRECT_INDEXED,
+	OPMODE_DIRECT_INDIRECT_LONG,
+	OPMODE_DIRECT_INDIRECT_LONG_INDEXED,
+	OPMODE_ABSOLUTE,
+	OPMODE_ABSOLUTE_X,
+	OPMODE_ABSOLUTE_Y,
+	OPMODE_LONG,
+	OPMODE_LONG_X,
+	OPMODE_ABSOLUTE_INDIRECT,
+	OPMODE_ABSOLUTE_INDEXED_INDIRECT,
+	OPMODE_ABSOLUTE_INDIRECT_LONG,
+	OPMODE_STACK_RELATIVE,
+	OPMODE_STACK_RELATIVE_INDIRECT_INDEXED,
+	OPMODE_RELATIVE,
+	OPMODE_RELATIVE_LONG,
+	OPMODE_BLOCK_MOVE,
+	OPMODE_COUNT
+};
+
+static const char	*OpModeNames[OPMODE_COUNT] =
+{
+	"implied",
+	"accumulator",
+	"#immediate",
+	"dp",
+	"dp,X",
+	"dp,Y",
+	"(dp)",
+	"(dp,X)",
+	"(dp),Y",
+	"[dp]",
+	"[dp],Y",
+	"abs",
+	"abs,X",
+	"abs,Y",
+	"long",
+	"long,X",
+	"(abs)",
+	"(abs,X)",
+	"[abs]",
+	"sr,S",
+	"(sr,S),Y",
+	"relative",
+	"relative long",
+	"block move"
+};
+
+// BRK, COP, WDM, REP and SEP are counted as #immediate (signature/operand byte),
+// PEA as abs and PEI as (dp), after the operand they take
+static const char	OpMnemonics[256][4] =
+{
+	"BRK", "ORA", "COP", "ORA", "TSB", "ORA", "ASL", "ORA", "PHP", "ORA", "ASL", "PHD", "TSB", "ORA", "ASL", "ORA",
+	"BPL", "ORA", "ORA", "ORA", "TRB", "ORA", "ASL", "ORA", "CLC", "ORA", "INC", "TCS", "TRB", "ORA", "ASL", "ORA",
+	"JSR", "AND", "JSL", "AND", "BIT", "AND", "ROL", "AND", "PLP", "AND", "ROL", "PLD", "BIT", "AND", "ROL", "AND",
+	"BMI", "AND", "AND", "AND", "BIT", "AND", "ROL", "AND", "SEC", "AND", "DEC", "TSC", "BIT", "AND", "ROL", "AND",
+	"RTI", "EOR", "WDM", "EOR", "MVP", "EOR", "LSR", "EOR", "PHA", "EOR", "LSR", "PHK", "JMP", "EOR", "LSR", "EOR",
+	"BVC", "EOR", "EOR", "EOR", "MVN", "EOR", "LSR", "EOR", "CLI", "EOR", "PHY", "TCD", "JML", "EOR", "LSR", "EOR",
+	"RTS", "ADC", "PER", "ADC", "STZ", "ADC", "ROR", "ADC", "PLA", "ADC", "ROR", "RTL", "JMP", "ADC", "ROR", "ADC",
+	"BVS", "ADC", "ADC", "ADC", "STZ", "ADC", "ROR", "ADC", "SEI", "ADC", "PLY", "TDC", "JMP", "ADC", "ROR", "ADC",
+	"BRA", "STA", "BRL", "STA", "STY", "STA", "STX", "STA", "DEY", "BIT", "TXA", "PHB", "STY", "STA", "STX", "STA",
+	"BCC", "STA", "STA", "STA", "STY", "STA", "STX", "STA", "TYA", "STA", "TXS", "TXY", "STZ", "STA", "STZ", "STA",
+	"LDY", "LDA", "LDX", "LDA", "LDY", "LDA", "LDX", "LDA", "TAY", "LDA", "TAX", "PLB", "LDY", "LDA", "LDX", "LDA",
+	"BCS", "LDA", "LDA", "LDA", "LDY", "LDA", "LDX", "LDA", "CLV", "LDA", "TSX", "TYX", "LDY", "LDA", "LDX", "LDA",
+	"CPY", "CMP", "REP", "CMP", "CPY", "CMP", "DEC", "CMP", "INY", "CMP", "DEX", "WAI", "CPY", "CMP", "DEC", "CMP",
+	"BNE", "CMP", "CMP", "CMP", "PEI", "CMP", "DEC", "CMP", "CLD", "CMP", "PHX", "STP", "JML", "CMP", "DEC", "CMP",
+	"CPX", "SBC", "SEP", "SBC", "CPX", "SBC", "INC", "SBC", "INX", "SBC", "NOP", "XBA", "CPX", "SBC", "INC", "SBC",
+	"BEQ", "SBC", "SBC", "SBC", "PEA", "SBC", "INC", "SBC", "SED", "SBC", "PLX", "XCE", "JSR", "SBC", "INC", "SBC"
+};
+
+static const uint8	OpModes[256] =
+{
+	 2,  7,  2, 19,  3,  3,  3,  9,  0,  2,  1,  0, 11, 11, 11, 14,	// 00
+	21,  8,  6, 20,  3,  4,  4, 10,  0, 13,  1,  0, 11, 12, 12, 15,	// 10
+	11,  7, 14, 19,  3,  3,  3,  9,  0,  2,  1,  0, 11, 11, 11, 14,	// 20
+	21,  8,  6, 20,  4,  4,  4, 10,  0, 13,  1,  0, 12, 12, 12, 15,	// 30
+	 0,  7,  2, 19, 23,  3,  3,  9,  0,  2,  1,  0, 11, 11, 11, 14,	// 40
+	21,  8,  6, 20, 23,  4,  4, 10,  0, 13,  0,  0, 14, 12, 12, 15,	// 50
+	 0,  7, 22, 19,  3,  3,  3,  9,  0,  2,  1,  0, 16, 11, 11, 14,	// 60
+	21,  8,  6, 20,  4,  4,  4, 10,  0, 13,  0,  0, 17, 12, 12, 15,	// 70
+	21,  7, 22, 19,  3,  3,  3,  9,  0,  2,  0,  0, 11, 11, 11, 14,	// 80
+	21,  8,  6, 20,  4,  4,  5, 10,  0, 13,  0,  0, 11, 12, 12, 15,	// 90
+	 2,  7,  2, 19,  3,  3,  3,  9,  0,  2,  0,  0, 11, 11, 11, 14,	// A0
+	21,  8,  6, 20,  4,  4,  5, 10,  0, 13,  0,  0, 12, 12, 13, 15,	// B0
+	 2,  7,  2, 19,  3,  3,  3,  9,  0,  2,  0,  0, 11, 11, 11, 14,	// C0
+	21,  8,  6, 20,  6,  4,  4, 10,  0, 13,  0,  0, 18, 12, 12, 15,	// D0
+	 2,  7,  2, 19,  3,  3,  3,  9,  0,  2,  0,  0, 11, 11, 11, 14,	// E0
+	21,  8,  6, 20, 11,  4,  4, 10,  0, 13,  0,  0, 17, 12, 12, 15	// F0
+};
+
+
+struct OpStatsEntry
+{
+	uint32	id;
+	uint64	count;
+	uint64	slow;
+};
+
+static bool OpStatsGreater (const OpStatsEntry &a, const OpStatsEntry &b)
+{
+	return (a.count > b.count || (a.count == b.count && a.id < b.id));
+}
+
+static double Percent (uint64 part, uint64 whole)
+{
+	return (whole ? part * 100.0 / whole : 0.0);
+}
+
+void S9xOpcodeStatsReset (void)
+{
+	memset(&OpcodeStats, 0, sizeof(OpcodeStats));
+}
+
+// Sorted report: fast/slow dispatch totals, then opcodes, addressing modes and
+// the 'top' hottest PC pages, each with the share that ran from S9xOpcodesSlow
+void S9xOpcodeStatsReport (FILE *fp, int top)
+{
+	static OpStatsEntry	pages[0x10000];
+	OpStatsEntry		ops[256], modes[OPMODE_COUNT];
+	uint64				fast = 0, slow = 0;
+
+	for (int m = 0; m < OPMODE_COUNT; m++)
+	{
+		modes[m].id = m;
+		modes[m].count = modes[m].slow = 0;
+	}
+
+	for (int op = 0; op < 256; op++)
+	{
+		ops[op].id = op;
+		ops[op].count = OpcodeStats.Fast[op] + OpcodeStats.Slow[op];
+		ops[op].slow = OpcodeStats.Slow[op];
+		modes[OpModes[op]].count += ops[op].count;
+		modes[OpModes[op]].slow += ops[op].slow;
+		fast += OpcodeStats.Fast[op];
+		slow += OpcodeStats.Slow[op];
+	}
+
+	int	used = 0;
+
+	for (uint32 p = 0; p < 0x10000; p++)
+	{
+		if (OpcodeStats.Pages[p])
+		{
+			pages[used].id = p;
+			pages[used].count = OpcodeStats.Pages[p];
+			pages[used].slow = OpcodeStats.SlowPages[p];
+			used++;
+		}
+	}
+
+	std::sort(ops, ops + 256, OpStatsGreater);
+	std::sort(modes, modes + OPMODE_COUNT, OpStatsGreater);
+	std::sort(pages, pages + used, OpStatsGreater);
+
+	uint64	total = fast + slow;
+
+	fprintf(fp, "opcodes executed: %llu\n", (unsigned long long) total);
+	fprintf(fp, "  fast table:     %llu (%.2f%%)\n", (unsigned long long) fast, Percent(fast, total));
+	fprintf(fp, "  slow table:     %llu (%.2f%%)\n", (unsigned long long) slow, Percent(slow, total));
+	fprintf(fp, "    no PCBase:    %llu\n", (unsigned long long) OpcodeStats.NoPCBase);
+	fprintf(fp, "    block edge:   %llu\n", (unsigned long long) (slow - OpcodeStats.NoPCBase));
+
+	fprintf(fp, "\nopcode            count      %%   slow%%\n");
+	for (int i = 0; i < 256 && ops[i].count; i++)
+		fprintf(fp, "  %02X %s %-13s %10llu %6.2f %6.2f\n", ops[i].id, OpMnemonics[ops[i].id], OpModeNames[OpModes[ops[i].id]],
+			(unsigned long long) ops[i].count, Percent(ops[i].count, total), Percent(ops[i].slow, ops[i].count));
+
+	fprintf(fp, "\naddressing mode   count      %%   slow%%\n");
+	for (int i = 0; i < OPMODE_COUNT && modes[i].count; i++)
+		fprintf(fp, "  %-14s %10llu %6.2f %6.2f\n", OpModeNames[modes[i].id],
+			(unsigned long long) modes[i].count, Percent(modes[i].count, total), Percent(modes[i].slow, modes[i].count));
+
+	fprintf(fp, "\nPC page           count      %%   slow%%\n");
+	for (int i = 0; i < used && i < top; i++)
+		fprintf(fp, "  %02X:%02X00-%02XFF %10llu %6.2f %6.2f\n", pages[i].id >> 8, pages[i].id & 0xff, pages[i].id & 0xff,
+			(unsigned long long) pages[i].count, Percent(pages[i].count, total), Percent(pages[i].slow, pages[i].count));
+}
+
+#endif
@@ -0,0 +1,61 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifndef _OPSTATS_H_
+#define _OPSTATS_H_
+
+// 65c816 execution histogram. Only built when OPCODE_STATS is defined;
+// otherwise every OPSTATS_* macro expands to nothing.
+//
+// S9xMainLoop records every dispatched opcode together with the table it was
+// run from: ICPU.S9xOpcodes when it could be fetched through CPU.PCBase, or
+// S9xOpcodesSlow when PCBase was NULL (I/O, mapped hardware) or the
+// instruction straddles a MEMMAP_BLOCK_SIZE block. Executions are also counted
+// per 256-byte page of the 24-bit PC. Addressing modes are derived from the
+// opcode counts when the report is written.
+
+#ifdef OPCODE_STATS
+
+struct SOpcodeStats
+{
+	uint64	Fast[256];				// opcode dispatched from ICPU.S9xOpcodes
+	uint64	Slow[256];				// opcode dispatched from S9xOpcodesSlow
+	uint64	NoPCBase;				// slow dispatches because CPU.PCBase was NULL
+	uint32	Pages[0x10000];			// executions per PBPC >> 8
+	uint32	SlowPages[0x10000];
+};
+
+extern struct SOpcodeStats	OpcodeStats;
+
+static inline void S9xOpcodeStatsRecord (uint8 op, uint32 pc, bool8 slow)
+{
+	if (slow)
+	{
+		OpcodeStats.Slow[op]++;
+		OpcodeStats.SlowPages[pc >> 8]++;
+	}
+	else
+		OpcodeStats.Fast[op]++;
+
+	OpcodeStats.Pages[pc >> 8]++;
+}
+
+void S9xOpcodeStatsReset (void);
+void S9xOpcodeStatsReport (FILE *, int);
+
+#define OPSTATS_RESET()					S9xOpcodeStatsReset()
+#define OPSTATS_NO_PCBASE()				OpcodeStats.NoPCBase++
+#define OPSTATS_RECORD(op, pc, slow)	S9xOpcodeStatsRecord(op, pc, slow)
+
+#else
+
+#define OPSTATS_RESET()
+#define OPSTATS_NO_PCBASE()
+#define OPSTATS_RECORD(op, pc, slow)
+
+#endif
+
+#endif
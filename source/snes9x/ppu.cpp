@@ -179,6 +179,8 @@ void S9xUpdateIRQPositions (bool initial)
 		}
 	}
 
+	S9xScheduleInterruptCheck();
+
 #ifdef DEBUGGER
 	S9xTraceFormattedMessage("--- IRQ Timer HC:%d VC:%d set %d cycles HTimer:%d Pos:%04d->%04d  VTimer:%d Pos:%03d->%03d", CPU.Cycles, CPU.V_Counter,
 		Timings.NextIRQTimer, PPU.HTimerEnabled, PPU.IRQHBeamPos, PPU.HTimerPosition, PPU.VTimerEnabled, PPU.IRQVBeamPos, PPU.VTimerPosition);
@@ -1404,6 +1406,7 @@ void S9xSetCPU (uint8 Byte, uint16 Address)
 					// FIXME: triggered at HC+=6, checked just before the final CPU cycle,
 					// then, when to call S9xOpcode_NMI()?
 					Timings.IRQFlagChanging |= IRQ_TRIGGER_NMI;
+					S9xScheduleInterruptCheck();
 
 					#ifdef DEBUGGER
 					if (Settings.TraceHCEvent)
@@ -1747,6 +1750,7 @@ void S9xResetPPUFast (void)
 	memset(IPPU.TileCached[TILE_2BIT_ODD], 0, MAX_2BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT_EVEN], 0, MAX_4BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT_ODD], 0, MAX_4BIT_TILES);
+	memset(IPPU.TileDirty, 0, sizeof(IPPU.TileDirty));
 }
 
 void S9xSoftResetPPU (void)
@@ -1893,6 +1897,7 @@ void S9xSoftResetPPU (void)
 	memset(IPPU.TileCached[TILE_2BIT_ODD], 0,  MAX_2BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT_EVEN], 0, MAX_4BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT_ODD], 0,  MAX_4BIT_TILES);
+	memset(IPPU.TileDirty, 0, sizeof(IPPU.TileDirty));
 	PPU.VRAMReadBuffer = 0; // XXX: FIXME: anything better?
 	GFX.InterlaceFrame = 0;
 	GFX.DoInterlace = 0;
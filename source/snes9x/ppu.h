@@ -38,9 +38,11 @@ struct InternalPPU
 {
 	struct ClipData Clip[2][6];
 	bool8	ColorsChanged;
-	bool8	OBJChanged;
+	bool8	OBJChanged;				// OBJ setup must be redone from scratch
+	uint32	OBJDirty[128 / 32];		// OAM entries changed since SetupOBJ, a bit per sprite
 	uint8	*TileCache[7];
 	uint8	*TileCached[7];
+	uint32	TileDirty[MAX_2BIT_TILES / 32];	// VRAM written since S9xUpdateTileCache, a bit per 16 bytes
 	bool8	Interlace;
 	bool8	InterlaceOBJ;
 	bool8	PseudoHires;
@@ -248,6 +250,13 @@ static inline void S9xUpdateVRAMReadBuffer()
 		PPU.VRAMReadBuffer = READ_WORD(Memory.VRAM + ((PPU.VMA.Address << 1) & 0xffff));
 }
 
+// A sprite's OAM entry changed in a way that can move it between lines, so
+// SetupOBJ has to redo the lines it was on and the ones it's on now.
+static inline void S9xMarkOBJDirty (int S)
+{
+	IPPU.OBJDirty[S >> 5] |= 1u << (S & 31);
+}
+
 static inline void REGISTER_2104 (uint8 Byte)
 {
 	if (!(PPU.OAMFlip & 1))
@@ -263,10 +272,15 @@ static inline void REGISTER_2104 (uint8 Byte)
 		{
 			FLUSH_REDRAW();
 			PPU.OAMData[addr] = Byte;
-			IPPU.OBJChanged = TRUE;
 
 			// X position high bit, and sprite size (x4)
-			struct SOBJ *pObj = &PPU.OBJ[(addr & 0x1f) * 4];
+			int S = (addr & 0x1f) * 4;
+			S9xMarkOBJDirty(S);
+			S9xMarkOBJDirty(S + 1);
+			S9xMarkOBJDirty(S + 2);
+			S9xMarkOBJDirty(S + 3);
+
+			struct SOBJ *pObj = &PPU.OBJ[S];
 			pObj->HPos = (pObj->HPos & 0xFF) | SignExtend[(Byte >> 0) & 1];
 			pObj++->Size = Byte & 2;
 			pObj->HPos = (pObj->HPos & 0xFF) | SignExtend[(Byte >> 2) & 1];
@@ -291,10 +305,12 @@ static inline void REGISTER_2104 (uint8 Byte)
 			FLUSH_REDRAW();
 			PPU.OAMData[addr] = lowbyte;
 			PPU.OAMData[addr + 1] = highbyte;
-			IPPU.OBJChanged = TRUE;
 			if (addr & 2)
 			{
-				// Tile
+				// Tile. Only the V flip is baked into the OBJ lines, the rest
+				// is read as the sprite is drawn.
+				if (PPU.OBJ[PPU.OAMAddr >> 1].VFlip != ((highbyte >> 7) & 1))
+					S9xMarkOBJDirty(PPU.OAMAddr >> 1);
 				PPU.OBJ[addr = PPU.OAMAddr >> 1].Name = PPU.OAMWriteRegister & 0x1ff;
 				// priority, h and v flip.
 				PPU.OBJ[addr].Palette  = (highbyte >> 1) & 7;
@@ -305,6 +321,7 @@ static inline void REGISTER_2104 (uint8 Byte)
 			else
 			{
 				// X position (low)
+				S9xMarkOBJDirty(PPU.OAMAddr >> 1);
 				PPU.OBJ[addr = PPU.OAMAddr >> 1].HPos &= 0xff00;
 				PPU.OBJ[addr].HPos |= lowbyte;
 				// Sprite Y position
@@ -331,6 +348,14 @@ static inline void REGISTER_2104 (uint8 Byte)
 	}
 }
 
+// VRAM writes only mark the 16-byte block dirty. The eleven tile cache
+// flags that cover it are cleared in bulk by S9xUpdateTileCache before the
+// next range is rendered.
+static inline void S9xMarkTileDirty (uint32 address)
+{
+	IPPU.TileDirty[address >> 9] |= 1u << ((address >> 4) & 31);
+}
+
 // This code is correct, however due to Snes9x's inaccurate timings, some games might be broken by this chage. :(
 #ifdef DEBUGGER
 #define CHECK_INBLANK() \
@@ -367,17 +392,7 @@ static inline void REGISTER_2118 (uint8 Byte)
 	else
 		Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byte;
 
-	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xMarkTileDirty(address);
 
 	if (!PPU.VMA.High)
 	{
@@ -398,17 +413,7 @@ static inline void REGISTER_2118_tile (uint8 Byte)
 
 	Memory.VRAM[address] = Byte;
 
-	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xMarkTileDirty(address);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -422,17 +427,7 @@ static inline void REGISTER_2118_linear (uint8 Byte)
 
 	Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byte;
 
-	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xMarkTileDirty(address);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -474,17 +469,7 @@ static inline void REGISTER_2119 (uint8 Byte)
 	else
 		Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byte;
 
-	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xMarkTileDirty(address);
 
 	if (PPU.VMA.High)
 	{
@@ -505,17 +490,7 @@ static inline void REGISTER_2119_tile (uint8 Byte)
 
 	Memory.VRAM[address] = Byte;
 
-	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xMarkTileDirty(address);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -529,17 +504,7 @@ static inline void REGISTER_2119_linear (uint8 Byte)
 
 	Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byte;
 
-	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_EVEN][((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [address >> 4] = FALSE;
-	IPPU.TileCached[TILE_2BIT_ODD] [((address >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
-	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xMarkTileDirty(address);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -0,0 +1,157 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifdef PROFILER
+
+#include <sys/time.h>
+#include "snes9x.h"
+#include "profiler.h"
+
+struct SProfiler	Profiler;
+
+const char	*S9xProfilerSectionNames[PROF_COUNT] =
+{
+	"frontend",
+	"cpu",
+	"hevent",
+	"hdma",
+	"ppu",
+	"apu",
+	"sa1",
+	"superfx"
+};
+
+static uint64 WallTimeUS (void)
+{
+	struct timeval	tv;
+	gettimeofday(&tv, NULL);
+	return ((uint64) tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+void S9xProfilerReset (void)
+{
+	memset(&Profiler, 0, sizeof(Profiler));
+	Profiler.Stack[0] = PROF_FRONTEND;
+	Profiler.Last = S9xProfilerTicks();
+	Profiler.ResetTicks = Profiler.Last;
+	Profiler.ResetTime = WallTimeUS();
+}
+
+double S9xProfilerToNS (uint64 ticks)
+{
+#ifdef GEKKO
+	return ((double) ticks * 1000000.0 / TB_TIMER_CLOCK);
+#elif defined(__i386__) || defined(__x86_64__)
+	uint64	elapsedTicks = S9xProfilerTicks() - Profiler.ResetTicks;
+	uint64	elapsedTime  = WallTimeUS() - Profiler.ResetTime;
+
+	if (!elapsedTicks)
+		return (0.0);
+
+	return ((double) ticks * elapsedTime * 1000.0 / elapsedTicks);
+#else
+	return ((double) ticks);
+#endif
+}
+
+void S9xProfilerEndFrame (void)
+{
+	uint64	now = S9xProfilerTicks();
+
+	Profiler.Current.Ticks[Profiler.Stack[Profiler.Depth]] += now - Profiler.Last;
+	Profiler.Last = now;
+
+	Profiler.Frames[Profiler.FrameIndex] = Profiler.Current;
+	Profiler.FrameIndex = (Profiler.FrameIndex + 1) % PROFILE_FRAMES;
+	Profiler.FrameCount++;
+
+	memset(&Profiler.Current, 0, sizeof(Profiler.Current));
+}
+
+// One-line breakdown of the last 'frames' frames in percent, for the on-screen display,
+// followed by the clip window cache hit rate
+void S9xProfilerSummary (char *string, int len, int frames)
+{
+	uint64	ticks[PROF_COUNT] = { 0 };
+	uint64	total = 0;
+	uint32	clipHits = 0, clipLookups = 0;
+
+	if (frames > (int) Profiler.FrameCount)
+		frames = Profiler.FrameCount;
+	if (frames > PROFILE_FRAMES)
+		frames = PROFILE_FRAMES;
+
+	for (int f = 1; f <= frames; f++)
+	{
+		struct SProfileFrame	*frame = &Profiler.Frames[(Profiler.FrameIndex + PROFILE_FRAMES - f) % PROFILE_FRAMES];
+
+		for (int s = 0; s < PROF_COUNT; s++)
+		{
+			ticks[s] += frame->Ticks[s];
+			total += frame->Ticks[s];
+		}
+
+		clipHits += frame->ClipHits;
+		clipLookups += frame->ClipHits + frame->ClipMisses;
+	}
+
+	*string = 0;
+
+	if (!total)
+		return;
+
+	// Frontend time is left out, it's mostly spent waiting for vsync
+	static const char	abbrev[PROF_COUNT][4] = { "", "CPU", "EVT", "DMA", "PPU", "APU", "SA1", "GSU" };
+	int					pos = 0;
+
+	for (int s = PROF_CPU; s < PROF_COUNT && pos < len; s++)
+	{
+		int	pct = (int) (ticks[s] * 100 / total);
+
+		if (pct > 0 || s == PROF_CPU)
+			pos += snprintf(string + pos, len - pos, "%s%s%d", pos ? " " : "", abbrev[s], pct);
+	}
+
+	if (clipLookups && pos < len)
+		snprintf(string + pos, len - pos, " CLIP%d%%", (int) ((uint64) clipHits * 100 / clipLookups));
+}
+
+// Writes the ring buffer, oldest frame first: per-section time in ns, then per-section call counts,
+// opcodes and clip window cache lookups
+bool8 S9xProfilerDumpCSV (const char *filename)
+{
+	FILE	*fp = fopen(filename, "w");
+
+	if (!fp)
+		return (FALSE);
+
+	fprintf(fp, "frame");
+	for (int s = 0; s < PROF_COUNT; s++)
+		fprintf(fp, ",%s_ns", S9xProfilerSectionNames[s]);
+	for (int s = 0; s < PROF_COUNT; s++)
+		fprintf(fp, ",%s_calls", S9xProfilerSectionNames[s]);
+	fprintf(fp, ",opcodes,clip_hits,clip_misses\n");
+
+	uint32	frames = Profiler.FrameCount < PROFILE_FRAMES ? Profiler.FrameCount : PROFILE_FRAMES;
+
+	for (uint32 f = 0; f < frames; f++)
+	{
+		struct SProfileFrame	*frame = &Profiler.Frames[(Profiler.FrameIndex + PROFILE_FRAMES - frames + f) % PROFILE_FRAMES];
+
+		fprintf(fp, "%u", Profiler.FrameCount - frames + f);
+		for (int s = 0; s < PROF_COUNT; s++)
+			fprintf(fp, ",%.0f", S9xProfilerToNS(frame->Ticks[s]));
+		for (int s = 0; s < PROF_COUNT; s++)
+			fprintf(fp, ",%u", frame->Calls[s]);
+		fprintf(fp, ",%u,%u,%u\n", frame->Opcodes, frame->ClipHits, frame->ClipMisses);
+	}
+
+	fclose(fp);
+
+	return (TRUE);
+}
+
+#endif
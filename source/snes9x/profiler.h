@@ -0,0 +1,134 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+// Per-subsystem frame profiler. Only built when PROFILER is defined; otherwise
+// every PROFILE_* macro expands to nothing.
+//
+// Time is charged exclusively: entering a section pauses the one below it on
+// the stack, so the per-section times of a frame add up to the whole frame.
+// PROF_FRONTEND is the bottom of the stack (time outside S9xMainLoop, plus
+// S9xSyncSpeed and S9xDeinitUpdate); PROF_CPU covers opcode dispatch and
+// everything in S9xMainLoop not claimed by another section.
+
+enum
+{
+	PROF_FRONTEND = 0,
+	PROF_CPU,
+	PROF_HEVENT,
+	PROF_HDMA,
+	PROF_PPU,
+	PROF_APU,
+	PROF_SA1,
+	PROF_SUPERFX,
+	PROF_COUNT
+};
+
+#ifdef PROFILER
+
+#ifdef GEKKO
+#include <ogc/lwp_watchdog.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#define PROFILE_FRAMES		256
+#define PROFILE_MAX_DEPTH	16
+
+struct SProfileFrame
+{
+	uint64	Ticks[PROF_COUNT];
+	uint32	Calls[PROF_COUNT];
+	uint32	Opcodes;
+	uint32	ClipHits;		// S9xComputeClipWindows served from its cache
+	uint32	ClipMisses;
+};
+
+struct SProfiler
+{
+	struct SProfileFrame	Current;
+	struct SProfileFrame	Frames[PROFILE_FRAMES];	// ring buffer of the last frames
+	uint32	FrameIndex;			// next slot to be written in Frames
+	uint32	FrameCount;			// frames recorded since reset
+
+	uint8	Stack[PROFILE_MAX_DEPTH];
+	int32	Depth;
+	uint64	Last;
+	uint64	ResetTicks;			// used to calibrate the tick rate against
+	uint64	ResetTime;			// the wall clock on hosts without a fixed one
+};
+
+extern struct SProfiler	Profiler;
+extern const char		*S9xProfilerSectionNames[PROF_COUNT];
+
+static inline uint64 S9xProfilerTicks (void)
+{
+#ifdef GEKKO
+	return (gettime());
+#elif defined(__i386__) || defined(__x86_64__)
+	return (__rdtsc());
+#else
+	struct timespec	ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64) ts.tv_sec * 1000000000 + ts.tv_nsec);
+#endif
+}
+
+static inline void S9xProfilerEnter (int section)
+{
+	uint64	now = S9xProfilerTicks();
+
+	Profiler.Current.Ticks[Profiler.Stack[Profiler.Depth]] += now - Profiler.Last;
+	Profiler.Last = now;
+	Profiler.Current.Calls[section]++;
+
+	if (Profiler.Depth < PROFILE_MAX_DEPTH - 1)
+		Profiler.Depth++;
+	Profiler.Stack[Profiler.Depth] = section;
+}
+
+static inline void S9xProfilerLeave (void)
+{
+	uint64	now = S9xProfilerTicks();
+
+	Profiler.Current.Ticks[Profiler.Stack[Profiler.Depth]] += now - Profiler.Last;
+	Profiler.Last = now;
+
+	if (Profiler.Depth > 0)
+		Profiler.Depth--;
+}
+
+void S9xProfilerReset (void);
+void S9xProfilerEndFrame (void);
+double S9xProfilerToNS (uint64);
+void S9xProfilerSummary (char *, int, int);
+bool8 S9xProfilerDumpCSV (const char *);
+
+#define PROFILE_RESET()			S9xProfilerReset()
+#define PROFILE_ENTER(s)		S9xProfilerEnter(s)
+#define PROFILE_LEAVE()			S9xProfilerLeave()
+#define PROFILE_OPCODE()		Profiler.Current.Opcodes++
+#define PROFILE_CLIP_HIT()		Profiler.Current.ClipHits++
+#define PROFILE_CLIP_MISS()		Profiler.Current.ClipMisses++
+#define PROFILE_END_FRAME()		S9xProfilerEndFrame()
+
+#else
+
+#define PROFILE_RESET()
+#define PROFILE_ENTER(s)
+#define PROFILE_LEAVE()
+#define PROFILE_OPCODE()
+#define PROFILE_CLIP_HIT()
+#define PROFILE_CLIP_MISS()
+#define PROFILE_END_FRAME()
+
+#endif
+
+#endif
@@ -0,0 +1,424 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snes9x.h"
+#include "snapshot.h"
+#include "rewind.h"
+
+#ifdef REWIND_THREAD
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+// A delta is a list of tokens, each a uint16 count of unchanged words, a
+// uint16 count of changed words and then that many XORed words. Undoing it
+// on the newer state gives the older one back.
+
+struct SRewindDelta
+{
+	uint32	Offset;
+	uint32	Size;
+};
+
+#ifdef REWIND_THREAD
+// The worker encodes the delta between the capture and the newest state, so
+// the emulation thread only pays for S9xMemSnapshotSave. Both state buffers
+// belong to the worker until S9xRewindWait returns.
+struct SRewindThread
+{
+	pthread_t	thread;
+	sem_t		start;
+	sem_t		done;
+	bool8		quit;
+	bool8		busy;
+};
+#endif
+
+static struct
+{
+	uint32					*State;		// newest state, whole
+	uint32					*Capture;	// state being pushed
+	uint32					StateSize;	// bytes, a multiple of 4
+	bool8					HaveState;
+	uint8					*Ring;
+	uint32					RingSize;
+	uint32					MaxDelta;	// encoded size of the worst delta
+	uint32					Head;		// end of the newest delta
+	struct SRewindDelta		*Deltas;	// oldest first, from First on
+	uint32					First;
+	uint32					Count;
+	uint32					Interval;
+	uint32					Frame;
+#ifdef REWIND_THREAD
+	struct SRewindThread	*Thread;
+#endif
+}	Rewind;
+
+struct SRewindStats	RewindStats;
+
+static void S9xRewindWait (void);
+
+static uint32 EncodeDelta (const uint32 *a, const uint32 *b, uint32 words, uint8 *out)
+{
+	uint8	*p = out;
+	uint32	i = 0;
+
+	while (i < words)
+	{
+		uint32	zeros = 0, literals = 0;
+
+		// Most of a state is unchanged, so skip it four words at a time
+		while (i + 4 <= words && zeros <= 0xffff - 4 &&
+			!((a[i] ^ b[i]) | (a[i + 1] ^ b[i + 1]) | (a[i + 2] ^ b[i + 2]) | (a[i + 3] ^ b[i + 3])))
+		{
+			zeros += 4;
+			i += 4;
+		}
+
+		while (i < words && zeros < 0xffff && a[i] == b[i])
+		{
+			zeros++;
+			i++;
+		}
+
+		uint16	*header = (uint16 *) p;
+		uint32	*lit = (uint32 *) (p + 4);
+
+		while (i < words && literals < 0xffff && a[i] != b[i])
+		{
+			lit[literals++] = a[i] ^ b[i];
+			i++;
+		}
+
+		header[0] = zeros;
+		header[1] = literals;
+		p += 4 + literals * 4;
+	}
+
+	return (p - out);
+}
+
+static void DecodeDelta (uint32 *state, const uint8 *in, uint32 size)
+{
+	const uint8	*p = in, *end = in + size;
+	uint32		i = 0;
+
+	while (p < end)
+	{
+		const uint16	*header = (const uint16 *) p;
+		const uint32	*lit = (const uint32 *) (p + 4);
+
+		i += header[0];
+
+		for (uint32 n = 0; n < header[1]; n++)
+			state[i++] ^= lit[n];
+
+		p += 4 + header[1] * 4;
+	}
+}
+
+static void DropOldest (void)
+{
+	Rewind.First = (Rewind.First + 1) % REWIND_MAX_STATES;
+	Rewind.Count--;
+	RewindStats.Dropped++;
+}
+
+// Finds MaxDelta contiguous bytes after the newest delta, wrapping to the
+// start of the ring if the end is too close. Deltas stay in address order
+// apart from that one wrap, so whatever is in the way is always the oldest.
+static uint32 MakeRoom (void)
+{
+	uint32	pos = Rewind.Head;
+	bool8	wrapped = FALSE;
+
+	if (pos + Rewind.MaxDelta > Rewind.RingSize)
+	{
+		pos = 0;
+		wrapped = TRUE;
+	}
+
+	uint32	end = pos + Rewind.MaxDelta;
+
+	while (Rewind.Count)
+	{
+		uint32	offset = Rewind.Deltas[Rewind.First].Offset;
+		bool8	inTheWay = wrapped ? (offset >= Rewind.Head || offset < end) : (offset >= pos && offset < end);
+
+		if (!inTheWay && Rewind.Count < REWIND_MAX_STATES)
+			break;
+
+		DropOldest();
+	}
+
+	return (pos);
+}
+
+// Stores the newest state as a delta against the capture, which becomes the
+// newest state
+static void CommitCapture (void)
+{
+	uint32	pos = MakeRoom();
+	uint32	size = EncodeDelta(Rewind.State, Rewind.Capture, Rewind.StateSize / 4, Rewind.Ring + pos);
+
+	struct SRewindDelta	&d = Rewind.Deltas[(Rewind.First + Rewind.Count) % REWIND_MAX_STATES];
+	d.Offset = pos;
+	d.Size = size;
+	Rewind.Count++;
+	Rewind.Head = pos + size;
+
+	uint32	*t = Rewind.State;
+	Rewind.State = Rewind.Capture;
+	Rewind.Capture = t;
+
+	RewindStats.Bytes += size;
+}
+
+#ifdef REWIND_THREAD
+static void *S9xRewindThreadMain (void *arg)
+{
+	struct SRewindThread	*t = (struct SRewindThread *) arg;
+
+	for (;;)
+	{
+		sem_wait(&t->start);
+		if (t->quit)
+			break;
+
+		CommitCapture();
+
+		sem_post(&t->done);
+	}
+
+	return (NULL);
+}
+
+bool8 S9xRewindStartThread (void)
+{
+	if (Rewind.Thread)
+		return (TRUE);
+
+	struct SRewindThread	*t = (struct SRewindThread *) calloc(1, sizeof(struct SRewindThread));
+	if (!t)
+		return (FALSE);
+
+	sem_init(&t->start, 0, 0);
+	sem_init(&t->done, 0, 0);
+
+	if (pthread_create(&t->thread, NULL, S9xRewindThreadMain, t))
+	{
+		sem_destroy(&t->start);
+		sem_destroy(&t->done);
+		free(t);
+		return (FALSE);
+	}
+
+	Rewind.Thread = t;
+
+	return (TRUE);
+}
+
+static void S9xRewindStopThread (void)
+{
+	struct SRewindThread	*t = Rewind.Thread;
+
+	if (!t)
+		return;
+
+	S9xRewindWait();
+
+	t->quit = TRUE;
+	sem_post(&t->start);
+	pthread_join(t->thread, NULL);
+
+	sem_destroy(&t->start);
+	sem_destroy(&t->done);
+	free(t);
+	Rewind.Thread = NULL;
+}
+#endif
+
+static void S9xRewindWait (void)
+{
+#ifdef REWIND_THREAD
+	struct SRewindThread	*t = Rewind.Thread;
+
+	if (t && t->busy)
+	{
+		sem_wait(&t->done);
+		t->busy = FALSE;
+	}
+#endif
+}
+
+// 'budget' is every byte the rewind buffer may use, the two whole states
+// included. A state is captured every 'interval' calls to S9xRewindFrame.
+bool8 S9xRewindInit (uint32 budget, uint32 interval)
+{
+	S9xRewindDeinit();
+
+	Rewind.StateSize = S9xMemSnapshotSize();
+	Rewind.MaxDelta = Rewind.StateSize + 4 * (Rewind.StateSize / 4 / 0xffff + 2);
+	Rewind.Interval = interval ? interval : 1;
+
+	uint32	fixed = Rewind.StateSize * 2 + REWIND_MAX_STATES * sizeof(struct SRewindDelta);
+
+	if (budget < fixed + Rewind.MaxDelta)
+		return (FALSE);
+
+	Rewind.RingSize = budget - fixed;
+	Rewind.State = (uint32 *) calloc(1, Rewind.StateSize);
+	Rewind.Capture = (uint32 *) calloc(1, Rewind.StateSize);
+	Rewind.Deltas = (struct SRewindDelta *) malloc(REWIND_MAX_STATES * sizeof(struct SRewindDelta));
+	Rewind.Ring = (uint8 *) malloc(Rewind.RingSize);
+
+	if (!Rewind.State || !Rewind.Capture || !Rewind.Deltas || !Rewind.Ring)
+	{
+		S9xRewindDeinit();
+		return (FALSE);
+	}
+
+	memset(&RewindStats, 0, sizeof(RewindStats));
+
+	return (TRUE);
+}
+
+void S9xRewindDeinit (void)
+{
+#ifdef REWIND_THREAD
+	S9xRewindStopThread();
+#endif
+
+	free(Rewind.State);
+	free(Rewind.Capture);
+	free(Rewind.Deltas);
+	free(Rewind.Ring);
+	memset(&Rewind, 0, sizeof(Rewind));
+}
+
+// Forgets every state, e.g. after a reset or loading a snapshot
+void S9xRewindReset (void)
+{
+	S9xRewindWait();
+
+	Rewind.HaveState = FALSE;
+	Rewind.Head = Rewind.First = Rewind.Count = 0;
+	Rewind.Frame = 0;
+}
+
+// Called by the host once per emulated frame. Returns TRUE on the frames a
+// state was captured.
+bool8 S9xRewindFrame (void)
+{
+	if (!Rewind.Ring || ++Rewind.Frame < Rewind.Interval)
+		return (FALSE);
+
+	Rewind.Frame = 0;
+	S9xRewindPush();
+
+	return (TRUE);
+}
+
+void S9xRewindPush (void)
+{
+	if (!Rewind.Ring)
+		return;
+
+	S9xRewindWait();
+
+	RewindStats.Captures++;
+
+	if (!Rewind.HaveState)
+	{
+		S9xMemSnapshotSave((uint8 *) Rewind.State);
+		Rewind.HaveState = TRUE;
+		return;
+	}
+
+	S9xMemSnapshotSave((uint8 *) Rewind.Capture);
+
+#ifdef REWIND_THREAD
+	if (Rewind.Thread)
+	{
+		Rewind.Thread->busy = TRUE;
+		sem_post(&Rewind.Thread->start);
+		return;
+	}
+#endif
+
+	CommitCapture();
+}
+
+// Restores the newest state and makes the one before it the newest, so
+// repeated calls step back one interval at a time. The oldest state is
+// restored again once there is nothing older.
+bool8 S9xRewindPop (void)
+{
+	if (!Rewind.HaveState)
+		return (FALSE);
+
+	S9xRewindWait();
+
+	bool8	rewinding = Settings.Rewinding;
+
+	Settings.Rewinding = TRUE;
+	int		result = S9xMemSnapshotLoad((const uint8 *) Rewind.State, Rewind.StateSize);
+	Settings.Rewinding = rewinding;
+
+	if (result != SUCCESS)
+	{
+		S9xRewindReset();
+		return (FALSE);
+	}
+
+	if (Rewind.Count)
+	{
+		struct SRewindDelta	&d = Rewind.Deltas[(Rewind.First + Rewind.Count - 1) % REWIND_MAX_STATES];
+
+		DecodeDelta(Rewind.State, Rewind.Ring + d.Offset, d.Size);
+
+		if (--Rewind.Count)
+		{
+			struct SRewindDelta	&n = Rewind.Deltas[(Rewind.First + Rewind.Count - 1) % REWIND_MAX_STATES];
+			Rewind.Head = n.Offset + n.Size;
+		}
+		else
+			Rewind.Head = 0;
+	}
+
+	Rewind.Frame = 0;
+	RewindStats.Pops++;
+
+	return (TRUE);
+}
+
+// States that S9xRewindPop can go back to
+uint32 S9xRewindCount (void)
+{
+	S9xRewindWait();
+
+	return (Rewind.HaveState ? Rewind.Count + 1 : 0);
+}
+
+uint32 S9xRewindBytesUsed (void)
+{
+	S9xRewindWait();
+
+	uint32	bytes = 0;
+
+	for (uint32 n = 0; n < Rewind.Count; n++)
+		bytes += Rewind.Deltas[(Rewind.First + n) % REWIND_MAX_STATES].Size;
+
+	return (bytes);
+}
+
+uint32 S9xRewindStateSize (void)
+{
+	return (Rewind.StateSize);
+}
@@ -0,0 +1,40 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifndef _REWIND_H_
+#define _REWIND_H_
+
+// Rewind buffer built on S9xMemSnapshotSave. Only the newest captured state
+// is kept whole; every older one is stored as the XOR of it and its successor,
+// run-length encoded, in a ring that fits the memory budget given to
+// S9xRewindInit. When the ring is full the oldest states are dropped.
+
+#define REWIND_MAX_STATES	8192
+
+struct SRewindStats
+{
+	uint32	Captures;	// states captured by S9xRewindPush
+	uint64	Bytes;		// encoded size of every delta stored
+	uint32	Dropped;	// oldest states dropped to make room
+	uint32	Pops;		// states restored by S9xRewindPop
+};
+
+extern struct SRewindStats	RewindStats;
+
+bool8 S9xRewindInit (uint32, uint32);
+void S9xRewindDeinit (void);
+void S9xRewindReset (void);
+bool8 S9xRewindFrame (void);
+void S9xRewindPush (void);
+bool8 S9xRewindPop (void);
+uint32 S9xRewindCount (void);
+uint32 S9xRewindBytesUsed (void);
+uint32 S9xRewindStateSize (void);
+#ifdef REWIND_THREAD
+bool8 S9xRewindStartThread (void);
+#endif
+
+#endif
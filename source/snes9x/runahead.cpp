@@ -0,0 +1,113 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snes9x.h"
+#include "memmap.h"
+#include "ppu.h"
+#include "gfx.h"
+#include "apu/apu.h"
+#include "snapshot.h"
+#include "movie.h"
+#include "display.h"
+#include "runahead.h"
+
+struct SRunAhead		RunAhead;
+struct SRunAheadStats	RunAheadStats;
+
+static uint8	*State = NULL;
+static uint32	StateSize = 0;
+
+// Must be called with the ROM loaded, as the snapshot size depends on it.
+// 'frames' is clamped to RUNAHEAD_MAX_FRAMES; 0 turns run-ahead off.
+bool8 S9xRunAheadInit (int frames)
+{
+	S9xRunAheadDeinit();
+
+	if (frames <= 0)
+		return (TRUE);
+
+	StateSize = S9xMemSnapshotSize();
+	State = (uint8 *) malloc(StateSize);
+	if (!State)
+		return (FALSE);
+
+	RunAhead.Frames = frames > RUNAHEAD_MAX_FRAMES ? RUNAHEAD_MAX_FRAMES : frames;
+	memset(&RunAheadStats, 0, sizeof(RunAheadStats));
+
+	return (TRUE);
+}
+
+void S9xRunAheadDeinit (void)
+{
+	free(State);
+	State = NULL;
+	StateSize = 0;
+	RunAhead.Frames = 0;
+	RunAhead.Hidden = FALSE;
+}
+
+// Call in place of S9xMainLoop. Skipped frames are never shown, so they and
+// movies, which would record the frames run ahead, just run the one frame.
+void S9xRunAheadFrame (void)
+{
+	if (!RunAhead.Frames || !IPPU.RenderThisFrame || S9xMovieActive())
+	{
+		S9xMainLoop();
+		return;
+	}
+
+	// The real frame: sound goes out, but nothing is drawn and S9xSyncSpeed
+	// is left to the frame that is shown
+	RunAhead.Hidden = TRUE;
+	IPPU.RenderThisFrame = FALSE;
+	S9xMainLoop();
+
+	uint32	frameCount = IPPU.FrameCount;
+	uint32	renderedCount = IPPU.RenderedFramesCount;
+	uint32	displayedCount = IPPU.DisplayedRenderedFrameCount;
+	uint32	totalFrames = IPPU.TotalEmulatedFrames;
+	uint32	infoTimeout = GFX.InfoStringTimeout;
+
+	S9xMemSnapshotSave(State);
+	// Sound from the real frame still waiting to be mixed belongs to it
+	S9xLandSamples();
+	S9xAPUSaveOutput();
+	S9xSetSoundDiscard(TRUE);
+
+	for (int f = 1; f < RunAhead.Frames; f++)
+		S9xMainLoop();
+
+	RunAhead.Hidden = FALSE;
+	IPPU.RenderThisFrame = TRUE;
+	S9xMainLoop();
+
+	RunAheadStats.Steps++;
+	RunAheadStats.Frames += RunAhead.Frames;
+
+	// What S9xSyncSpeed decided for the next frame
+	bool8	render = IPPU.RenderThisFrame;
+	uint32	skipped = IPPU.SkippedFrames;
+
+	if (S9xMemSnapshotLoad(State, StateSize) != SUCCESS)
+	{
+		S9xMessage(S9X_ERROR, S9X_WRONG_FORMAT, "Run-ahead state could not be restored, run-ahead turned off.");
+		S9xRunAheadDeinit();
+	}
+
+	S9xSetSoundDiscard(FALSE);
+	S9xAPULoadOutput();
+
+	IPPU.RenderThisFrame = render;
+	IPPU.SkippedFrames = skipped;
+	IPPU.FrameCount = frameCount;
+	IPPU.RenderedFramesCount = renderedCount + 1;
+	IPPU.DisplayedRenderedFrameCount = displayedCount;
+	IPPU.TotalEmulatedFrames = totalFrames;
+	GFX.InfoStringTimeout = infoTimeout;
+}
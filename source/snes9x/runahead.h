@@ -0,0 +1,36 @@
+/*****************************************************************************\
+     Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+                This file is licensed under the Snes9x License.
+   For further information, consult the LICENSE file in the root directory.
+\*****************************************************************************/
+
+#ifndef _RUNAHEAD_H_
+#define _RUNAHEAD_H_
+
+// Run-ahead hides the frames of input lag a game has of its own. Each call
+// to S9xRunAheadFrame runs the real frame, saves the state with
+// S9xMemSnapshotSave, runs Frames more with the same input and sound thrown
+// away, shows the last of them and then loads the saved state back.
+
+#define RUNAHEAD_MAX_FRAMES	4
+
+struct SRunAhead
+{
+	int		Frames;		// frames run ahead, 0 for off
+	bool8	Hidden;		// set while emulating a frame that is not shown
+};
+
+struct SRunAheadStats
+{
+	uint32	Steps;		// calls to S9xRunAheadFrame that ran ahead
+	uint32	Frames;		// extra frames emulated for them
+};
+
+extern struct SRunAhead			RunAhead;
+extern struct SRunAheadStats	RunAheadStats;
+
+bool8 S9xRunAheadInit (int);
+void S9xRunAheadDeinit (void);
+void S9xRunAheadFrame (void);
+
+#endif
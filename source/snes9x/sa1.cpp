@@ -288,6 +288,7 @@ void S9xSetSA1 (uint8 byte, uint32 address)
 			{
 				Memory.FillRAM[0x2202] &= ~0x80;
 				CPU.IRQExternal = TRUE;
+				S9xScheduleInterruptCheck();
 			}
 
 			// S-CPU CHDMA IRQ enable
@@ -295,6 +296,7 @@ void S9xSetSA1 (uint8 byte, uint32 address)
 			{
 				Memory.FillRAM[0x2202] &= ~0x20;
 				CPU.IRQExternal = TRUE;
+				S9xScheduleInterruptCheck();
 			}
 
 			break;
@@ -333,6 +335,7 @@ void S9xSetSA1 (uint8 byte, uint32 address)
 				{
 					Memory.FillRAM[0x2202] &= ~0x80;
 					CPU.IRQExternal = TRUE;
+					S9xScheduleInterruptCheck();
 				}
 			}
 
@@ -477,6 +480,7 @@ void S9xSetSA1 (uint8 byte, uint32 address)
 				{
 					Memory.FillRAM[0x2202] &= ~0x20;
 					CPU.IRQExternal = TRUE;
+					S9xScheduleInterruptCheck();
 				}
 			}
 
@@ -95,6 +95,19 @@ void S9xSA1Init (void);
 void S9xSA1MainLoop (void);
 void S9xSA1PostLoadState (void);
 
+// Compile-time wrap mode forms used by the shared opcode handlers (cpumacro.h)
+template <enum s9xwrap_t w>
+inline uint16 S9xSA1GetWord (uint32 address)
+{
+	return (S9xSA1GetWord(address, w));
+}
+
+template <enum s9xwrap_t w, enum s9xwriteorder_t o>
+inline void S9xSA1SetWord (uint16 Word, uint32 address)
+{
+	S9xSA1SetWord(Word, address, w, o);
+}
+
 static inline void S9xSA1UnpackStatus (void)
 {
 	SA1._Zero = (SA1Registers.PL & Zero) == 0;
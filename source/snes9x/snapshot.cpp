@@ -1171,6 +1171,9 @@ void S9xFreezeToStream (STREAM stream)
 
 	FreezeBlock (stream, "FIL", Memory.FillRAM, 0x8000);
 
+	// copy_state does not fill the whole block; keep the rest from changing
+	// between otherwise identical snapshots
+	memset(soundsnapshot, 0, SPC_SAVE_STATE_BLOCK_SIZE);
 	S9xAPUSaveState(soundsnapshot);
 	FreezeBlock (stream, "SND", soundsnapshot, SPC_SAVE_STATE_BLOCK_SIZE);
 
@@ -1797,6 +1800,325 @@ int S9xUnfreezeFromStream (STREAM stream)
 	return (result);
 }
 
+// In-memory snapshots, for rewind and the like. The image is a header and
+// then every piece of emulated state copied whole, in a fixed order, so
+// saving and loading are a series of memcpy calls and the size is known
+// without serializing anything. Structures go in as they are, pointers
+// included, so an image is only good in the process that made it and for
+// the ROM that was loaded at the time; .frz stays the format for anything
+// that is written out. Movie data and screenshots are not included.
+
+#define MEMSNAPSHOT_MAGIC		0x4d583953	// "S9XM"
+#define MEMSNAPSHOT_VERSION		1
+#define MEMSNAPSHOT_SECTIONS	32
+
+enum
+{
+	MEMSNAP_COPY,
+	MEMSNAP_VRAM,	// loaded a 16-byte block at a time, so that only the
+					// tiles that differ have to be decoded again
+	MEMSNAP_APU		// S9xAPUSaveState block, loaded with S9xAPURestoreState
+					// so that sound already mixed is not thrown away
+};
+
+struct SMemSnapshotHeader
+{
+	uint32	Magic;
+	uint32	Version;
+	uint32	Size;
+	uint32	ROMCRC32;
+	uint64	ROM;		// Memory.ROM of the process that made it
+};
+
+struct SMemSnapshotSection
+{
+	void	*Data;
+	uint32	Size;
+	int		Type;
+};
+
+static struct SControlSnapshot	memCtlSnap;
+
+#define MEMSNAP_ALIGN(n)	(((n) + 3) & ~3)
+
+#define MEMSNAP_SECTION(data, size, type) \
+	{ \
+		s[n].Data = (void *) (data); \
+		s[n].Size = (size); \
+		s[n].Type = (type); \
+		n++; \
+	}
+
+#define MEMSNAP_STRUCT(st)	MEMSNAP_SECTION(&(st), sizeof(st), MEMSNAP_COPY)
+
+// The fields from 'first' up to but not including 'last'
+#define MEMSNAP_FIELDS(st, first, last) \
+	MEMSNAP_SECTION(&(st).first, (uint8 *) &(st).last - (uint8 *) &(st).first, MEMSNAP_COPY)
+
+// The fields from 'first' to the end
+#define MEMSNAP_TAIL(st, first) \
+	MEMSNAP_SECTION(&(st).first, (uint8 *) (&(st) + 1) - (uint8 *) &(st).first, MEMSNAP_COPY)
+
+static uint32 MemSnapshotSRAMSize (void)
+{
+	// Coprocessors map SRAM their own way; plain carts only use SRAMMask + 1
+	if (Settings.SuperFX || Settings.SA1 || Settings.BS || Settings.SETA || Settings.SPC7110)
+		return (0x80000);
+
+	return (Memory.SRAMSize ? Memory.SRAMMask + 1 : 0);
+}
+
+static int MemSnapshotSections (struct SMemSnapshotSection *s)
+{
+	int	n = 0;
+
+	MEMSNAP_STRUCT(CPU);
+	MEMSNAP_STRUCT(Registers);
+	MEMSNAP_STRUCT(PPU);
+	MEMSNAP_STRUCT(DMA);
+	MEMSNAP_SECTION(Memory.VRAM, 0x10000, MEMSNAP_VRAM);
+	MEMSNAP_SECTION(Memory.RAM, 0x20000, MEMSNAP_COPY);
+	MEMSNAP_SECTION(Memory.SRAM, MemSnapshotSRAMSize(), MEMSNAP_COPY);
+	MEMSNAP_SECTION(Memory.FillRAM, 0x8000, MEMSNAP_COPY);
+	MEMSNAP_SECTION(NULL, SPC_SAVE_STATE_BLOCK_SIZE, MEMSNAP_APU);
+	MEMSNAP_STRUCT(memCtlSnap);
+	MEMSNAP_STRUCT(Timings);
+
+	if (Settings.SuperFX)
+		MEMSNAP_STRUCT(GSU);
+
+	if (Settings.SA1)
+	{
+		// Not the memory maps, which only change with the ROM
+		MEMSNAP_FIELDS(SA1, S9xOpcodes, Map);
+		MEMSNAP_TAIL(SA1, BWRAM);
+		MEMSNAP_STRUCT(SA1Registers);
+	}
+
+	if (Settings.DSP == 1)
+		MEMSNAP_STRUCT(DSP1);
+
+	if (Settings.DSP == 2)
+		MEMSNAP_STRUCT(DSP2);
+
+	if (Settings.DSP == 4)
+		MEMSNAP_STRUCT(DSP4);
+
+	if (Settings.C4)
+		MEMSNAP_SECTION(Memory.C4RAM, 8192, MEMSNAP_COPY);
+
+	if (Settings.SETA == ST_010)
+		MEMSNAP_STRUCT(ST010);
+
+	if (Settings.OBC1)
+	{
+		MEMSNAP_STRUCT(OBC1);
+		MEMSNAP_SECTION(Memory.OBC1RAM, 8192, MEMSNAP_COPY);
+	}
+
+	if (Settings.SPC7110)
+		MEMSNAP_STRUCT(s7snap);
+
+	if (Settings.SRTC)
+		MEMSNAP_STRUCT(srtcsnap);
+
+	if (Settings.SRTC || Settings.SPC7110RTC)
+		MEMSNAP_SECTION(RTCData.reg, 20, MEMSNAP_COPY);
+
+	if (Settings.BS)
+	{
+		// Around the satellite data streams
+		MEMSNAP_FIELDS(BSX, dirty, sat_stream1);
+		MEMSNAP_TAIL(BSX, sat_pf_latch1_enable);
+	}
+
+	if (Settings.MSU1)
+		MEMSNAP_STRUCT(MSU1);
+
+	return (n);
+}
+
+uint32 S9xMemSnapshotSize (void)
+{
+	struct SMemSnapshotSection	s[MEMSNAPSHOT_SECTIONS];
+	int		n = MemSnapshotSections(s);
+	uint32	size = sizeof(struct SMemSnapshotHeader);
+
+	for (int i = 0; i < n; i++)
+		size += MEMSNAP_ALIGN(s[i].Size);
+
+	return (size);
+}
+
+// 'buf' must hold S9xMemSnapshotSize() bytes
+void S9xMemSnapshotSave (uint8 *buf)
+{
+	struct SMemSnapshotSection	s[MEMSNAPSHOT_SECTIONS];
+	struct SMemSnapshotHeader	*h = (struct SMemSnapshotHeader *) buf;
+	int		n = MemSnapshotSections(s);
+	uint8	*ptr = buf + sizeof(struct SMemSnapshotHeader);
+
+	S9xControlPreSaveState(&memCtlSnap);
+
+	if (Settings.SuperFX)
+		GSU.avRegAddr = (uint8 *) &GSU.avReg;
+
+	if (Settings.SA1)
+		S9xSA1PackStatus();
+
+	if (Settings.SPC7110)
+		S9xSPC7110PreSaveState();
+
+	if (Settings.SRTC)
+		S9xSRTCPreSaveState();
+
+	// The clip windows live in IPPU and are always recomputed after loading;
+	// store the flag that way so that the same state gives the same image
+	bool8	recompute = PPU.RecomputeClipWindows;
+	PPU.RecomputeClipWindows = TRUE;
+
+	for (int i = 0; i < n; i++)
+	{
+		uint32	size = MEMSNAP_ALIGN(s[i].Size);
+
+		if (s[i].Type == MEMSNAP_APU)
+		{
+			memset(ptr, 0, size);
+			S9xAPUSaveState(ptr);
+		}
+		else
+		{
+			memcpy(ptr, s[i].Data, s[i].Size);
+			memset(ptr + s[i].Size, 0, size - s[i].Size);
+		}
+
+		ptr += size;
+	}
+
+	PPU.RecomputeClipWindows = recompute;
+
+	h->Magic = MEMSNAPSHOT_MAGIC;
+	h->Version = MEMSNAPSHOT_VERSION;
+	h->Size = ptr - buf;
+	h->ROMCRC32 = Memory.ROMCRC32;
+	h->ROM = (uint64) (pint) Memory.ROM;
+}
+
+static void MemSnapshotLoadVRAM (const uint8 *src)
+{
+	const uint32	*from = (const uint32 *) src;
+	uint32			*to = (uint32 *) Memory.VRAM;
+
+	for (uint32 i = 0; i < 0x10000 / 4; i += 4)
+	{
+		if ((from[i] ^ to[i]) | (from[i + 1] ^ to[i + 1]) | (from[i + 2] ^ to[i + 2]) | (from[i + 3] ^ to[i + 3]))
+		{
+			memcpy(to + i, from + i, 16);
+			S9xMarkTileDirty(i * 4);
+		}
+	}
+}
+
+int S9xMemSnapshotLoad (const uint8 *buf, uint32 bufSize)
+{
+	struct SMemSnapshotSection	s[MEMSNAPSHOT_SECTIONS];
+	const struct SMemSnapshotHeader	*h = (const struct SMemSnapshotHeader *) buf;
+	int		n = MemSnapshotSections(s);
+
+	if (bufSize < sizeof(struct SMemSnapshotHeader) || h->Magic != MEMSNAPSHOT_MAGIC)
+		return (WRONG_FORMAT);
+
+	if (h->Version != MEMSNAPSHOT_VERSION)
+		return (WRONG_VERSION);
+
+	if (h->Size != S9xMemSnapshotSize() || h->Size > bufSize || h->ROMCRC32 != Memory.ROMCRC32 || h->ROM != (uint64) (pint) Memory.ROM)
+		return (WRONG_FORMAT);
+
+	uint32	old_flags     = CPU.Flags;
+	uint32	sa1_old_flags = SA1.Flags;
+#if defined(GEKKO) || defined(HEADLESS)
+	int32	superfx_speed = Timings.SuperFX2CoreSpeed;
+#endif
+	const uint8	*ptr = buf + sizeof(struct SMemSnapshotHeader);
+
+	for (int i = 0; i < n; i++)
+	{
+		switch (s[i].Type)
+		{
+			case MEMSNAP_VRAM:
+				MemSnapshotLoadVRAM(ptr);
+				break;
+
+			case MEMSNAP_APU:
+				S9xAPURestoreState((uint8 *) ptr);
+				break;
+
+			default:
+				memcpy(s[i].Data, ptr, s[i].Size);
+				break;
+		}
+
+		ptr += MEMSNAP_ALIGN(s[i].Size);
+	}
+
+#if defined(GEKKO) || defined(HEADLESS)
+	Timings.SuperFX2CoreSpeed = superfx_speed;
+#endif
+
+	// What S9xResetPPUFast and the end of S9xUnfreezeFromStream do, minus
+	// throwing away the whole tile cache
+	PPU.RecomputeClipWindows = TRUE;
+	IPPU.ColorsChanged = TRUE;
+	IPPU.OBJChanged = TRUE;
+	IPPU.RenderThisFrame = TRUE;
+
+	CPU.Flags = (CPU.Flags & ~(DEBUG_MODE_FLAG | TRACE_FLAG | SINGLE_STEP_FLAG | FRAME_ADVANCE_FLAG)) |
+		(old_flags & (DEBUG_MODE_FLAG | TRACE_FLAG | SINGLE_STEP_FLAG | FRAME_ADVANCE_FLAG));
+	ICPU.ShiftedPB = Registers.PB << 16;
+	ICPU.ShiftedDB = Registers.DB << 16;
+	S9xSetPCBase(Registers.PBPC);
+	S9xUnpackStatus();
+	S9xFixCycles();
+
+	S9xFixColourBrightness();
+	S9xBuildDirectColourMaps();
+
+	GFX.InterlaceFrame = Timings.InterlaceField;
+	GFX.DoInterlace = 0;
+	S9xGraphicsScreenResize();
+
+	S9xControlPostLoadState(&memCtlSnap);
+
+	if (Settings.SuperFX)
+	{
+		GSU.pfPlot = fx_PlotTable[GSU.vMode];
+		GSU.pfRpix = fx_PlotTable[GSU.vMode + 5];
+	}
+
+	if (Settings.SA1)
+	{
+		SA1.Flags = (SA1.Flags & ~TRACE_FLAG) | (sa1_old_flags & TRACE_FLAG);
+		S9xSA1PostLoadState();
+	}
+
+	if (Settings.SDD1)
+		S9xSDD1PostLoadState();
+
+	if (Settings.SPC7110)
+		S9xSPC7110PostLoadState(SNAPSHOT_VERSION);
+
+	if (Settings.SRTC)
+		S9xSRTCPostLoadState(SNAPSHOT_VERSION);
+
+	if (Settings.BS)
+		S9xBSXPostLoadState();
+
+	if (Settings.MSU1)
+		S9xMSU1PostLoadState();
+
+	return (SUCCESS);
+}
+
 static int FreezeSize (int size, int type)
 {
 	switch (type)
@@ -31,5 +31,8 @@ bool8 S9xUnfreezeGame (const char *);
 int S9xUnfreezeGameMem (const uint8 *,uint32);
 void S9xFreezeToStream (STREAM);
 int	 S9xUnfreezeFromStream (STREAM);
+uint32 S9xMemSnapshotSize (void);
+void S9xMemSnapshotSave (uint8 *);
+int S9xMemSnapshotLoad (const uint8 *, uint32);
 
 #endif
@@ -68,7 +68,7 @@
 #define SNES_MAX_PAL_VCOUNTER		312
 #define SNES_HCOUNTER_MAX			341
 
-#ifdef GEKKO
+#if defined(GEKKO) || defined(HEADLESS)
 #define ONE_CYCLE      (Settings.OneClockCycle)
 #define SLOW_ONE_CYCLE (Settings.OneSlowClockCycle)
 #define TWO_CYCLES     (Settings.TwoClockCycles)
@@ -137,6 +137,7 @@ struct SCPUState
 	int32	CurrentDMAorHDMAChannel;
 	uint8	WhichEvent;
 	int32	NextEvent;
+	int32	InterruptHorizon;	// see S9xUpdateInterruptHorizon()
 	bool8	WaitingForInterrupt;
 	uint32	AutoSaveTimer;
 	bool8	SRAMModified;
@@ -181,7 +182,7 @@ struct STimings
 	int32	IRQFlagChanging;	// This value is just a hack.
 	int32	APUSpeedup;
 	bool8	APUAllowTimeOverflow;
-#ifdef GEKKO
+#if defined(GEKKO) || defined(HEADLESS)
 	int32	SuperFX2CoreSpeed;		// Make the SuperFX2 Core Speed adjustable
 #endif
 };
@@ -240,9 +241,11 @@ struct SSettings
 	bool8	Mute;
 	bool8	DynamicRateControl;
 	int32	InterpolationMethod;
+	int32	ResamplerMethod;	// RESAMPLER_* in apu/resampler.h
 
 	bool8	SupportHiRes;
 	bool8	Transparency;
+	int32	RenderThreads;		// extra band renderers, RENDER_THREADS builds only
 	uint8	BG_Forced;
 	bool8	DisableGraphicWindows;
 
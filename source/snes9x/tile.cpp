@@ -6,8 +6,18 @@
 
 #include "tileimpl.h"
 
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+	#define TILE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define TILE_NEON 1
+#endif
+
 using namespace TileImpl;
 
+struct STileCacheStats	TileCacheStats;
+
 namespace {
 
 	uint32	pixbit[8][16];
@@ -15,6 +25,179 @@ namespace {
 	uint8	hrbit_even[256];
 
 	// Here are the tile converters, selected by S9xSelectTileConverter().
+	// A tile row becomes 8 bytes, one per pixel, with bit i of each taken
+	// from bitplane i.
+
+#if defined(TILE_SSE2) || defined(TILE_NEON)
+
+	// Whole-tile SIMD transpose. Each 16 bytes of source are the 8 rows of a
+	// pair of bitplanes, interleaved (2bpp, and the second half of 4bpp and so
+	// on). Every row is spread to [plane 2p x8 | plane 2p+1 x8], tested
+	// against the pixel masks, and the two halves are folded into the row's
+	// 8 output bytes at the end.
+
+	template<int pairs>
+	alwaysinline uint8 ConvertPlanes (uint8 *pCache, const uint8 *tp)
+	{
+	#if defined(TILE_SSE2)
+		const __m128i	mask = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+		const __m128i	zero = _mm_setzero_si128();
+		__m128i			acc[8], any = zero;
+
+		for (int r = 0; r < 8; r++)
+			acc[r] = zero;
+
+		for (int p = 0; p < pairs; p++)
+		{
+			__m128i	x   = _mm_loadu_si128((const __m128i *) (tp + p * 16));
+			__m128i	bit = _mm_unpacklo_epi64(_mm_set1_epi8(1 << (p * 2)), _mm_set1_epi8(2 << (p * 2)));
+			__m128i	lo  = _mm_unpacklo_epi8(x, x);
+			__m128i	hi  = _mm_unpackhi_epi8(x, x);
+			__m128i	w[4] = { _mm_unpacklo_epi16(lo, lo), _mm_unpackhi_epi16(lo, lo), _mm_unpacklo_epi16(hi, hi), _mm_unpackhi_epi16(hi, hi) };
+
+			any = _mm_or_si128(any, x);
+
+			for (int q = 0; q < 4; q++)
+			{
+				__m128i	r0 = _mm_unpacklo_epi32(w[q], w[q]);
+				__m128i	r1 = _mm_unpackhi_epi32(w[q], w[q]);
+
+				acc[q * 2]     = _mm_or_si128(acc[q * 2],     _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(r0, mask), mask), bit));
+				acc[q * 2 + 1] = _mm_or_si128(acc[q * 2 + 1], _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(r1, mask), mask), bit));
+			}
+		}
+
+		for (int r = 0; r < 8; r += 2)
+			_mm_storeu_si128((__m128i *) (pCache + r * 8), _mm_or_si128(_mm_unpacklo_epi64(acc[r], acc[r + 1]), _mm_unpackhi_epi64(acc[r], acc[r + 1])));
+
+		return (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xffff ? TRUE : BLANK_TILE);
+	#else
+		static const uint8	mask_bytes[16] = { 0x80, 0x40, 0x20, 0x10, 8, 4, 2, 1, 0x80, 0x40, 0x20, 0x10, 8, 4, 2, 1 };
+		const uint8x16_t	mask = vld1q_u8(mask_bytes);
+		uint8x16_t			acc[8], any = vdupq_n_u8(0);
+
+		for (int r = 0; r < 8; r++)
+			acc[r] = any;
+
+		for (int p = 0; p < pairs; p++)
+		{
+			uint8x16_t		x   = vld1q_u8(tp + p * 16);
+			uint8x16_t		bit = vcombine_u8(vdup_n_u8(1 << (p * 2)), vdup_n_u8(2 << (p * 2)));
+			uint8x16x2_t	z8  = vzipq_u8(x, x);
+
+			any = vorrq_u8(any, x);
+
+			for (int h = 0; h < 2; h++)
+			{
+				uint16x8x2_t	z16 = vzipq_u16(vreinterpretq_u16_u8(z8.val[h]), vreinterpretq_u16_u8(z8.val[h]));
+
+				for (int k = 0; k < 2; k++)
+				{
+					uint32x4x2_t	z32 = vzipq_u32(vreinterpretq_u32_u16(z16.val[k]), vreinterpretq_u32_u16(z16.val[k]));
+					int				r = h * 4 + k * 2;
+
+					acc[r]     = vorrq_u8(acc[r],     vandq_u8(vtstq_u8(vreinterpretq_u8_u32(z32.val[0]), mask), bit));
+					acc[r + 1] = vorrq_u8(acc[r + 1], vandq_u8(vtstq_u8(vreinterpretq_u8_u32(z32.val[1]), mask), bit));
+				}
+			}
+		}
+
+		for (int r = 0; r < 8; r++)
+			vst1_u8(pCache + r * 8, vorr_u8(vget_low_u8(acc[r]), vget_high_u8(acc[r])));
+
+		return (vget_lane_u64(vreinterpret_u64_u8(vorr_u8(vget_low_u8(any), vget_high_u8(any))), 0) ? TRUE : BLANK_TILE);
+	#endif
+	}
+
+	uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
+	{
+		return (ConvertPlanes<1>(pCache, &Memory.VRAM[TileAddr]));
+	}
+
+	uint8 ConvertTile4 (uint8 *pCache, uint32 TileAddr, uint32)
+	{
+		return (ConvertPlanes<2>(pCache, &Memory.VRAM[TileAddr]));
+	}
+
+	uint8 ConvertTile8 (uint8 *pCache, uint32 TileAddr, uint32)
+	{
+		return (ConvertPlanes<4>(pCache, &Memory.VRAM[TileAddr]));
+	}
+
+	// Hires tiles take the odd or even pixels of this tile for the left half
+	// and of the next one for the right half: squeeze each pair of source
+	// bytes into one (what hrbit_odd/hrbit_even do a byte at a time), then
+	// convert as usual.
+
+	template<int pairs, int even>
+	alwaysinline uint8 ConvertHires (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+	{
+		uint8	*tp1 = &Memory.VRAM[TileAddr], *tp2;
+		uint8	planes[pairs * 16];
+
+		if (Tile == 0x3ff)
+			tp2 = tp1 - (0x3ff << (pairs + 3));
+		else
+			tp2 = tp1 + (1 << (pairs + 3));
+
+		for (int p = 0; p < pairs; p++)
+		{
+		#if defined(TILE_SSE2)
+			const __m128i	m55 = _mm_set1_epi8(0x55), m33 = _mm_set1_epi8(0x33), m0f = _mm_set1_epi8(0x0f);
+			__m128i			a = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *) (tp1 + p * 16)), even), m55);
+			__m128i			b = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *) (tp2 + p * 16)), even), m55);
+
+			a = _mm_and_si128(_mm_or_si128(a, _mm_srli_epi16(a, 1)), m33);
+			b = _mm_and_si128(_mm_or_si128(b, _mm_srli_epi16(b, 1)), m33);
+			a = _mm_and_si128(_mm_or_si128(a, _mm_srli_epi16(a, 2)), m0f);
+			b = _mm_and_si128(_mm_or_si128(b, _mm_srli_epi16(b, 2)), m0f);
+			_mm_storeu_si128((__m128i *) (planes + p * 16), _mm_or_si128(_mm_slli_epi16(a, 4), b));
+		#else
+			uint8x16_t	a = vld1q_u8(tp1 + p * 16);
+			uint8x16_t	b = vld1q_u8(tp2 + p * 16);
+
+			if (even)	// vshrq_n_u8 can't shift by 0
+			{
+				a = vshrq_n_u8(a, 1);
+				b = vshrq_n_u8(b, 1);
+			}
+
+			a = vandq_u8(a, vdupq_n_u8(0x55));
+			b = vandq_u8(b, vdupq_n_u8(0x55));
+
+			a = vandq_u8(vorrq_u8(a, vshrq_n_u8(a, 1)), vdupq_n_u8(0x33));
+			b = vandq_u8(vorrq_u8(b, vshrq_n_u8(b, 1)), vdupq_n_u8(0x33));
+			a = vandq_u8(vorrq_u8(a, vshrq_n_u8(a, 2)), vdupq_n_u8(0x0f));
+			b = vandq_u8(vorrq_u8(b, vshrq_n_u8(b, 2)), vdupq_n_u8(0x0f));
+			vst1q_u8(planes + p * 16, vorrq_u8(vshlq_n_u8(a, 4), b));
+		#endif
+		}
+
+		return (ConvertPlanes<pairs>(pCache, planes));
+	}
+
+	uint8 ConvertTile2h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+	{
+		return (ConvertHires<1, 0>(pCache, TileAddr, Tile));
+	}
+
+	uint8 ConvertTile4h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+	{
+		return (ConvertHires<2, 0>(pCache, TileAddr, Tile));
+	}
+
+	uint8 ConvertTile2h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+	{
+		return (ConvertHires<1, 1>(pCache, TileAddr, Tile));
+	}
+
+	uint8 ConvertTile4h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+	{
+		return (ConvertHires<2, 1>(pCache, TileAddr, Tile));
+	}
+
+#else
+
 	// Really, except for the definition of DOBIT and the number of times it is called, they're all the same.
 
 	#define DOBIT(n, i) \
@@ -235,8 +418,148 @@ namespace {
 
 	#undef DOBIT
 
+#endif
+
+	// Narrows [k0, k1) to the k for which P + k * s, in 8.8 fixed point, is
+	// inside the 1024x1024 playfield, so the Mode 7 fetch can split a line
+	// into the wrapped span and the Mode7Repeat spans either side up front.
+	inline int64 FloorDiv (int64 a, int64 d)
+	{
+		return (a >= 0 ? a / d : -((-a + d - 1) / d));
+	}
+
+	void Mode7Clip (int32 P, int32 s, int32 &k0, int32 &k1)
+	{
+		const int64	top = (1024 << 8) - 1;
+		int64		lo, hi;
+
+		if (s == 0)
+		{
+			if (P < 0 || P > top)
+				k1 = k0;
+			return;
+		}
+
+		if (s > 0)
+		{
+			lo = -FloorDiv(P, s);
+			hi = FloorDiv(top - P, s);
+		}
+		else
+		{
+			lo = -FloorDiv(top - P, -s);
+			hi = FloorDiv(P, -s);
+		}
+
+		if (lo > k0)
+			k0 = lo;
+		if (hi + 1 < k1)
+			k1 = hi + 1;
+		if (k1 < k0)
+			k1 = k0;
+	}
+
+	// The wrapped span. There's no gather, so the vector code works out the
+	// map and texel offsets of four pixels at once and the loads stay scalar.
+	void Mode7Span (uint8 *Texels, int32 k0, int32 k1, int32 X, int32 dX, int32 Y, int32 dY)
+	{
+		uint8	*VRAM1 = Memory.VRAM + 1;
+		int32	k = k0;
+
+		X += k0 * dX;
+		Y += k0 * dY;
+
+	#if defined(TILE_SSE2) || defined(TILE_NEON)
+		uint32	idx[4];
+
+		#if defined(TILE_SSE2)
+		__m128i			vx   = _mm_set_epi32(X + 3 * dX, X + 2 * dX, X + dX, X);
+		__m128i			vy   = _mm_set_epi32(Y + 3 * dY, Y + 2 * dY, Y + dY, Y);
+		const __m128i	sx   = _mm_set1_epi32(4 * dX), sy = _mm_set1_epi32(4 * dY);
+		const __m128i	m3ff = _mm_set1_epi32(0x3ff), m7 = _mm_set1_epi32(7), mrow = _mm_set1_epi32(~7), mcol = _mm_set1_epi32(~1);
+
+		for (; k + 4 <= k1; k += 4, vx = _mm_add_epi32(vx, sx), vy = _mm_add_epi32(vy, sy))
+		{
+			__m128i	x   = _mm_and_si128(_mm_srai_epi32(vx, 8), m3ff);
+			__m128i	y   = _mm_and_si128(_mm_srai_epi32(vy, 8), m3ff);
+			__m128i	map = _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(y, mrow), 5), _mm_and_si128(_mm_srli_epi32(x, 2), mcol));
+			__m128i	tex = _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(y, m7), 4), _mm_slli_epi32(_mm_and_si128(x, m7), 1));
+
+			_mm_storeu_si128((__m128i *) idx, _mm_or_si128(map, _mm_slli_epi32(tex, 16)));
+		#else
+		const int32		step[4] = { 0, 1, 2, 3 };
+		int32x4_t		vx   = vmlaq_n_s32(vdupq_n_s32(X), vld1q_s32(step), dX);
+		int32x4_t		vy   = vmlaq_n_s32(vdupq_n_s32(Y), vld1q_s32(step), dY);
+		const int32x4_t	sx   = vdupq_n_s32(4 * dX), sy = vdupq_n_s32(4 * dY);
+		const int32x4_t	m3ff = vdupq_n_s32(0x3ff), m7 = vdupq_n_s32(7), mrow = vdupq_n_s32(~7), mcol = vdupq_n_s32(~1);
+
+		for (; k + 4 <= k1; k += 4, vx = vaddq_s32(vx, sx), vy = vaddq_s32(vy, sy))
+		{
+			int32x4_t	x   = vandq_s32(vshrq_n_s32(vx, 8), m3ff);
+			int32x4_t	y   = vandq_s32(vshrq_n_s32(vy, 8), m3ff);
+			int32x4_t	map = vaddq_s32(vshlq_n_s32(vandq_s32(y, mrow), 5), vandq_s32(vshrq_n_s32(x, 2), mcol));
+			int32x4_t	tex = vaddq_s32(vshlq_n_s32(vandq_s32(y, m7), 4), vshlq_n_s32(vandq_s32(x, m7), 1));
+
+			vst1q_u32(idx, vreinterpretq_u32_s32(vorrq_s32(map, vshlq_n_s32(tex, 16))));
+		#endif
+
+			for (int j = 0; j < 4; j++)
+				Texels[k + j] = VRAM1[(Memory.VRAM[idx[j] & 0xffff] << 7) + (idx[j] >> 16)];
+		}
+
+		X += (k - k0) * dX;
+		Y += (k - k0) * dY;
+	#endif
+
+		for (; k < k1; k++, X += dX, Y += dY)
+		{
+			int	x = (X >> 8) & 0x3ff;
+			int	y = (Y >> 8) & 0x3ff;
+
+			Texels[k] = VRAM1[(Memory.VRAM[((y & ~7) << 5) + ((x >> 2) & ~1)] << 7) + ((y & 7) << 4) + ((x & 7) << 1)];
+		}
+	}
+
 } // anonymous namespace
 
+void TileImpl::Mode7Texels (uint8 *Texels, uint32 n, int32 X, int32 dX, int32 Y, int32 dY)
+{
+	int32	k0 = 0, k1 = n;
+
+	if (PPU.Mode7Repeat)
+	{
+		Mode7Clip(X, dX, k0, k1);
+		Mode7Clip(Y, dY, k0, k1);
+		if (k0 == k1)
+			k0 = k1 = 0;
+
+		if (PPU.Mode7Repeat == 3)
+		{
+			// Outside the playfield every texel comes from tile 0
+			uint8	*VRAM1 = Memory.VRAM + 1;
+
+			for (int32 k = 0; k < (int32) n; k++)
+			{
+				if (k == k0)
+					k = k1;
+				if (k == (int32) n)
+					break;
+
+				int	x = (X + k * dX) >> 8;
+				int	y = (Y + k * dY) >> 8;
+				Texels[k] = VRAM1[((y & 7) << 4) + ((x & 7) << 1)];
+			}
+		}
+		else
+		{
+			memset(Texels, 0, k0);
+			memset(Texels + k1, 0, n - k1);
+		}
+	}
+
+	Mode7Span(Texels, k0, k1, X, dX, Y, dY);
+}
+
 void S9xInitTileRenderer (void)
 {
 	int	i;
@@ -296,6 +619,43 @@ void S9xInitTileRenderer (void)
 	}
 }
 
+// Clears the cache flags of every tile that overlaps a dirty 16-byte block,
+// in every depth: the plain tile, and for hires the tile and the one before
+// it, whose right half is read from here.
+void S9xUpdateTileCache (void)
+{
+	for (int w = 0; w < MAX_2BIT_TILES / 32; w++)
+	{
+		uint32	dirty = IPPU.TileDirty[w];
+
+		if (!dirty)
+			continue;
+
+		IPPU.TileDirty[w] = 0;
+
+		do
+		{
+			uint32	t2 = (w << 5) | __builtin_ctz(dirty);
+			uint32	t4 = t2 >> 1;
+
+			IPPU.TileCached[TILE_2BIT][t2] = FALSE;
+			IPPU.TileCached[TILE_4BIT][t4] = FALSE;
+			IPPU.TileCached[TILE_8BIT][t2 >> 2] = FALSE;
+			IPPU.TileCached[TILE_2BIT_EVEN][t2] = FALSE;
+			IPPU.TileCached[TILE_2BIT_EVEN][(t2 - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
+			IPPU.TileCached[TILE_2BIT_ODD] [t2] = FALSE;
+			IPPU.TileCached[TILE_2BIT_ODD] [(t2 - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
+			IPPU.TileCached[TILE_4BIT_EVEN][t4] = FALSE;
+			IPPU.TileCached[TILE_4BIT_EVEN][(t4 - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+			IPPU.TileCached[TILE_4BIT_ODD] [t4] = FALSE;
+			IPPU.TileCached[TILE_4BIT_ODD] [(t4 - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+
+			TileCacheStats.Invalidations++;
+			dirty &= dirty - 1;
+		} while (dirty);
+	}
+}
+
 // Functions to select which converter and renderer to use.
 extern template struct TileImpl::Renderers<DrawTile16, Normal1x1>;
 extern template struct TileImpl::Renderers<DrawClippedTile16, Normal1x1>;
@@ -439,6 +799,204 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 	GFX.DrawBackdropMath    = DB[i];
 	GFX.DrawMode7BG1Math    = DM7BG1[i];
 	GFX.DrawMode7BG2Math    = DM7BG2[i];
+
+	// Only the hires plotters still blend as they draw
+	GFX.MathOp = (IPPU.DoubleWidthPixels && hires) ? 0 : i;
+}
+
+// The deferred colour math pass, see the MATH classes in tileimpl.h. Runs
+// at the end of the main screen, over the lines just drawn, and leaves
+// GFX.MathBuffer cleared behind it.
+namespace {
+
+	template<class MATH>
+	void ComposeLine (uint16 *s, const uint16 *sub, const uint8 *sd, uint8 *flags, uint32 width)
+	{
+		for (uint32 x = 0; x < width; x++)
+		{
+			if (flags[x])
+			{
+				s[x] = MATH::Blend(s[x], sub[x], sd[x], flags[x] & 2);
+				flags[x] = 0;
+			}
+		}
+	}
+
+#if (defined(TILE_SSE2) || defined(TILE_NEON)) && RED_SHIFT_BITS == 11 && GREEN_SHIFT_BITS == 6
+
+	// Eight RGB565 pixels at a time, one colour channel per step, so the
+	// add/subtract saturate in the lanes instead of through carry masks. The
+	// results are bit-identical to COLOR_ADD and COLOR_SUB in gfx.h, including
+	// the ZERO table lookup of the half subtract and the copy of the top
+	// green bit into the spare one.
+
+	#if defined(TILE_SSE2)
+	typedef __m128i		v16;
+
+	alwaysinline v16 VSet (uint16 a)				{ return _mm_set1_epi16(a); }
+	alwaysinline v16 VLoad (const uint16 *p)		{ return _mm_loadu_si128((const __m128i *) p); }
+	alwaysinline v16 VLoad8 (const uint8 *p)		{ return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) p), _mm_setzero_si128()); }
+	alwaysinline void VStore (uint16 *p, v16 a)		{ _mm_storeu_si128((__m128i *) p, a); }
+	alwaysinline v16 VAnd (v16 a, v16 b)			{ return _mm_and_si128(a, b); }
+	alwaysinline v16 VOr (v16 a, v16 b)				{ return _mm_or_si128(a, b); }
+	alwaysinline v16 VAdd (v16 a, v16 b)			{ return _mm_add_epi16(a, b); }
+	alwaysinline v16 VSub (v16 a, v16 b)			{ return _mm_sub_epi16(a, b); }
+	alwaysinline v16 VSubSat (v16 a, v16 b)			{ return _mm_subs_epu16(a, b); }
+	alwaysinline v16 VMin (v16 a, v16 b)			{ return _mm_min_epi16(a, b); }
+	alwaysinline v16 VSel (v16 m, v16 a, v16 b)		{ return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+	alwaysinline v16 VGe (v16 a, v16 b)				{ return _mm_cmpeq_epi16(_mm_subs_epu16(b, a), _mm_setzero_si128()); }
+	alwaysinline v16 VTest (v16 a, uint16 m)		{ return _mm_cmpgt_epi16(_mm_and_si128(a, _mm_set1_epi16(m)), _mm_setzero_si128()); }
+	template<int n> alwaysinline v16 VShr (v16 a)	{ return _mm_srli_epi16(a, n); }
+	template<int n> alwaysinline v16 VShl (v16 a)	{ return _mm_slli_epi16(a, n); }
+	#else
+	typedef uint16x8_t	v16;
+
+	alwaysinline v16 VSet (uint16 a)				{ return vdupq_n_u16(a); }
+	alwaysinline v16 VLoad (const uint16 *p)		{ return vld1q_u16(p); }
+	alwaysinline v16 VLoad8 (const uint8 *p)		{ return vmovl_u8(vld1_u8(p)); }
+	alwaysinline void VStore (uint16 *p, v16 a)		{ vst1q_u16(p, a); }
+	alwaysinline v16 VAnd (v16 a, v16 b)			{ return vandq_u16(a, b); }
+	alwaysinline v16 VOr (v16 a, v16 b)				{ return vorrq_u16(a, b); }
+	alwaysinline v16 VAdd (v16 a, v16 b)			{ return vaddq_u16(a, b); }
+	alwaysinline v16 VSub (v16 a, v16 b)			{ return vsubq_u16(a, b); }
+	alwaysinline v16 VSubSat (v16 a, v16 b)			{ return vqsubq_u16(a, b); }
+	alwaysinline v16 VMin (v16 a, v16 b)			{ return vminq_u16(a, b); }
+	alwaysinline v16 VSel (v16 m, v16 a, v16 b)		{ return vbslq_u16(m, a, b); }
+	alwaysinline v16 VGe (v16 a, v16 b)				{ return vcgeq_u16(a, b); }
+	alwaysinline v16 VTest (v16 a, uint16 m)		{ return vtstq_u16(a, vdupq_n_u16(m)); }
+	template<int n> alwaysinline v16 VShr (v16 a)	{ return vshrq_n_u16(a, n); }
+	template<int n> alwaysinline v16 VShl (v16 a)	{ return vshlq_n_u16(a, n); }
+	#endif
+
+	alwaysinline v16 VBuild (v16 r, v16 g, v16 b)
+	{
+		return VOr(VOr(VShl<11>(r), VShl<6>(g)), VOr(VShl<1>(VAnd(g, VSet(0x10))), b));
+	}
+
+	alwaysinline v16 VColorAdd (v16 a, v16 c)
+	{
+		const v16	m = VSet(0x1f);
+
+		return VBuild(VMin(VAdd(VShr<11>(a), VShr<11>(c)), m),
+					  VMin(VAdd(VAnd(VShr<6>(a), m), VAnd(VShr<6>(c), m)), m),
+					  VMin(VAdd(VAnd(a, m), VAnd(c, m)), m));
+	}
+
+	// Unlike the add, COLOR_SUB borrows from the spare bit, though it
+	// doesn't keep it
+	alwaysinline v16 VColorSub (v16 a, v16 c)
+	{
+		const v16	m = VSet(0x1f), m6 = VSet(0x3f);
+		v16			g = VSubSat(VAnd(VShr<5>(a), m6), VAnd(VShr<5>(c), m6));
+		v16			x = VOr(VOr(VShl<11>(VSubSat(VShr<11>(a), VShr<11>(c))), VAnd(VShl<5>(g), VSet(0x07c0))),
+							VSubSat(VAnd(a, m), VAnd(c, m)));
+
+		return VOr(x, VShr<5>(VAnd(x, VSet(0x0400))));
+	}
+
+	alwaysinline v16 VColorAdd1_2 (v16 a, v16 c)
+	{
+		const v16	hi = VSet(RGB_REMOVE_LOW_BITS_MASK & 0xffff);
+
+		return VAdd(VAdd(VShr<1>(VAnd(a, hi)), VShr<1>(VAnd(c, hi))), VAnd(VAnd(a, c), VSet(RGB_LOW_BITS_MASK)));
+	}
+
+	// GFX.ZERO[((a | RGB_HI_BITS_MASKx2) - (c & RGB_REMOVE_LOW_BITS_MASK)) >> 1]:
+	// bit 16 of the difference lands in bit 15 of the index, and ZERO keeps
+	// a channel less its top bit if that was set, or clears it.
+	alwaysinline v16 VColorSub1_2 (v16 a, v16 c)
+	{
+		v16	x = VOr(a, VSet(RGB_HI_BITS_MASKx2 & 0xffff));
+		v16	y = VAnd(c, VSet(RGB_REMOVE_LOW_BITS_MASK & 0xffff));
+		v16	i = VOr(VShr<1>(VSub(x, y)), VAnd(VGe(x, y), VSet(0x8000)));
+		v16	r = VAnd(i, VSet(RED_HI_BIT_MASK));
+		v16	g = VAnd(i, VSet(GREEN_HI_BIT_MASK));
+		v16	b = VAnd(i, VSet(BLUE_HI_BIT_MASK));
+
+		return VAnd(i, VOr(VOr(VSub(r, VShr<4>(r)), VSub(g, VShr<5>(g))), VSub(b, VShr<4>(b))));
+	}
+
+	enum { BLEND_REG, BLEND_F1_2, BLEND_S1_2 };
+
+	template<bool SUB>
+	alwaysinline v16 VFn (v16 a, v16 c)		{ return SUB ? VColorSub(a, c) : VColorAdd(a, c); }
+	template<bool SUB>
+	alwaysinline v16 VFn1_2 (v16 a, v16 c)	{ return SUB ? VColorSub1_2(a, c) : VColorAdd1_2(a, c); }
+
+	template<bool SUB, int MODE>
+	void ComposeLineSIMD (uint16 *s, const uint16 *sub, const uint8 *sd, uint8 *flags, uint32 width)
+	{
+		const v16	fixed = VSet(GFX.FixedColour);
+
+		for (uint32 x = 0; x < width; x += 8)
+		{
+			uint64	any;
+
+			memcpy(&any, flags + x, 8);
+			if (!any)
+				continue;
+
+			v16	f    = VLoad8(flags + x);
+			v16	clip = VTest(f, 2);
+			v16	m    = VLoad(s + x);
+			v16	r;
+
+			if (MODE == BLEND_F1_2)
+				r = VSel(clip, VFn<SUB>(m, fixed), VFn1_2<SUB>(m, fixed));
+			else
+			{
+				v16	sm  = VTest(VLoad8(sd + x), 0x20);
+				v16	sc  = VLoad(sub + x);
+				v16	src = VSel(sm, sc, fixed);
+
+				r = VFn<SUB>(m, src);
+				if (MODE == BLEND_S1_2)
+					r = VSel(VSel(clip, VSet(0), sm), VFn1_2<SUB>(m, sc), r);
+			}
+
+			VStore(s + x, VSel(VTest(f, 1), r, m));
+			memset(flags + x, 0, 8);
+		}
+	}
+
+#endif
+
+} // anonymous namespace
+
+void S9xComposeMath (void)
+{
+	void	(*line) (uint16 *, const uint16 *, const uint8 *, uint8 *, uint32);
+
+	switch (GFX.MathOp)
+	{
+	#if (defined(TILE_SSE2) || defined(TILE_NEON)) && RED_SHIFT_BITS == 11 && GREEN_SHIFT_BITS == 6
+		case 1:	line = ComposeLineSIMD<false, BLEND_REG>;		break;
+		case 2:	line = ComposeLineSIMD<false, BLEND_F1_2>;		break;
+		case 3:	line = ComposeLineSIMD<false, BLEND_S1_2>;		break;
+		case 4:	line = ComposeLineSIMD<true,  BLEND_REG>;		break;
+		case 5:	line = ComposeLineSIMD<true,  BLEND_F1_2>;		break;
+		case 6:	line = ComposeLineSIMD<true,  BLEND_S1_2>;		break;
+	#else
+		case 1:	line = ComposeLine<Blend_Add>;					break;
+		case 2:	line = ComposeLine<Blend_AddF1_2>;				break;
+		case 3:	line = ComposeLine<Blend_AddS1_2>;				break;
+		case 4:	line = ComposeLine<Blend_Sub>;					break;
+		case 5:	line = ComposeLine<Blend_SubF1_2>;				break;
+		case 6:	line = ComposeLine<Blend_SubS1_2>;				break;
+	#endif
+		case 7:	line = ComposeLine<Blend_AddBrightness>;		break;
+		case 8:	line = ComposeLine<Blend_AddS1_2Brightness>;	break;
+		default:
+			return;
+	}
+
+	uint32	width = IPPU.DoubleWidthPixels ? SNES_WIDTH * 2 : SNES_WIDTH;
+
+	for (uint32 y = GFX.StartY; y <= GFX.EndY; y++)
+	{
+		uint32	o = y * GFX.PPL;
+		line(GFX.S + o, GFX.SubScreen + o, GFX.SubZBuffer + o, GFX.MathBuffer + o, width);
+	}
 }
 
 void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
@@ -7,8 +7,18 @@
 #ifndef _TILE_H_
 #define _TILE_H_
 
+struct STileCacheStats
+{
+	uint32	Invalidations;	// dirty 16-byte VRAM blocks applied by S9xUpdateTileCache
+	uint32	Conversions;	// tiles decoded into IPPU.TileCache
+};
+
+extern struct STileCacheStats	TileCacheStats;
+
 void S9xInitTileRenderer (void);
+void S9xUpdateTileCache (void);
 void S9xSelectTileRenderers (int, bool8, bool8);
 void S9xSelectTileConverter (int, bool8, bool8, bool8);
+void S9xComposeMath (void);
 
 #endif
@@ -15,8 +15,9 @@ namespace TileImpl {
 		(void) OffsetInLine;
 		if (Z1 > GFX.DB[Offset + N] && (M))
 		{
-			GFX.S[Offset + N] = MATH::Calc(GFX.ScreenColors[Pix], GFX.SubScreen[Offset + N], GFX.SubZBuffer[Offset + N]);
+			GFX.S[Offset + N] = GFX.ScreenColors[Pix];
 			GFX.DB[Offset + N] = Z2;
+			GFX.MathBuffer[Offset + N] = MATH::Flag();
 		}
 	}
 
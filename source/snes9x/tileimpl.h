@@ -99,14 +99,20 @@ namespace TileImpl {
 			if (Tile & H_FLIP)
 			{
 				pCache = &BG.BufferFlip[TileNumber << 6];
-				if (!BG.BufferedFlip[TileNumber])
-					BG.BufferedFlip[TileNumber] = BG.ConvertTileFlip(pCache, TileAddr, Tile & 0x3ff);
+				if (!TILE_CACHED_GET(BG.BufferedFlip[TileNumber]))
+				{
+					TILE_CACHED_SET(BG.BufferedFlip[TileNumber], BG.ConvertTileFlip(pCache, TileAddr, Tile & 0x3ff));
+					TILE_STAT_INC(TileCacheStats.Conversions);
+				}
 			}
 			else
 			{
 				pCache = &BG.Buffer[TileNumber << 6];
-				if (!BG.Buffered[TileNumber])
-					BG.Buffered[TileNumber] = BG.ConvertTile(pCache, TileAddr, Tile & 0x3ff);
+				if (!TILE_CACHED_GET(BG.Buffered[TileNumber]))
+				{
+					TILE_CACHED_SET(BG.Buffered[TileNumber], BG.ConvertTile(pCache, TileAddr, Tile & 0x3ff));
+					TILE_STAT_INC(TileCacheStats.Conversions);
+				}
 			}
 		}
 
@@ -139,22 +145,33 @@ namespace TileImpl {
 	};
 
 
+	// Colour math. Calc() blends a main screen pixel as it's drawn, which only
+	// the hires plotters still do. The others store the unblended pixel and
+	// Flag() in GFX.MathBuffer, and S9xComposeMath() applies Blend() to the
+	// whole line once every layer is down, so covered pixels cost nothing.
+	// Bit 1 of the flag is GFX.ClipColors at the time the pixel was drawn.
+
+	#define MATH_FLAG	(1 | (GFX.ClipColors << 1))
+
 	struct NOMATH
 	{
 		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD)
 		{
 			return Main;
 		}
+		static alwaysinline uint8 Flag() { return 0; }
 	};
 	typedef NOMATH Blend_None;
 
 	template<class Op>
 	struct REGMATH
 	{
-		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD)
+		static alwaysinline uint16 Blend(uint16 Main, uint16 Sub, uint8 SD, bool8 Clip)
 		{
 			return Op::fn(Main, (SD & 0x20) ? Sub : GFX.FixedColour);
 		}
+		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD) { return Blend(Main, Sub, SD, GFX.ClipColors); }
+		static alwaysinline uint8 Flag() { return MATH_FLAG; }
 	};
 	typedef REGMATH<COLOR_ADD> Blend_Add;
 	typedef REGMATH<COLOR_SUB> Blend_Sub;
@@ -163,10 +180,12 @@ namespace TileImpl {
 	template<class Op>
 	struct MATHF1_2
 	{
-		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD)
+		static alwaysinline uint16 Blend(uint16 Main, uint16 Sub, uint8 SD, bool8 Clip)
 		{
-			return GFX.ClipColors ? Op::fn(Main, GFX.FixedColour) : Op::fn1_2(Main, GFX.FixedColour);
+			return Clip ? Op::fn(Main, GFX.FixedColour) : Op::fn1_2(Main, GFX.FixedColour);
 		}
+		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD) { return Blend(Main, Sub, SD, GFX.ClipColors); }
+		static alwaysinline uint8 Flag() { return MATH_FLAG; }
 	};
 	typedef MATHF1_2<COLOR_ADD> Blend_AddF1_2;
 	typedef MATHF1_2<COLOR_SUB> Blend_SubF1_2;
@@ -174,11 +193,15 @@ namespace TileImpl {
 	template<class Op>
 	struct MATHS1_2
 	{
-		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD)
+		static alwaysinline uint16 Blend(uint16 Main, uint16 Sub, uint8 SD, bool8 Clip)
 		{
-			return GFX.ClipColors ? REGMATH<Op>::Calc(Main, Sub, SD) : (SD & 0x20) ? Op::fn1_2(Main, Sub) : Op::fn(Main, GFX.FixedColour);
+			return Clip ? REGMATH<Op>::Blend(Main, Sub, SD, Clip) : (SD & 0x20) ? Op::fn1_2(Main, Sub) : Op::fn(Main, GFX.FixedColour);
 		}
+		static alwaysinline uint16 Calc(uint16 Main, uint16 Sub, uint8 SD) { return Blend(Main, Sub, SD, GFX.ClipColors); }
+		static alwaysinline uint8 Flag() { return MATH_FLAG; }
 	};
+
+	#undef MATH_FLAG
 	typedef MATHS1_2<COLOR_ADD> Blend_AddS1_2;
 	typedef MATHS1_2<COLOR_SUB> Blend_SubS1_2;
 	typedef MATHS1_2<COLOR_ADD_BRIGHTNESS> Blend_AddS1_2Brightness;
@@ -506,6 +529,11 @@ namespace TileImpl {
 
 	#define CLIP_10_BIT_SIGNED(a)	(((a) & 0x2000) ? ((a) | ~0x3ff) : ((a) & 0x3ff))
 
+	// Fetches the n Mode 7 texels of a line span, the k-th at 8.8 fixed point
+	// (X + k * dX, Y + k * dY), applying Mode7Repeat. Out of range texels that
+	// aren't drawn come back as 0, as they would for a transparent pixel.
+	void Mode7Texels (uint8 *Texels, uint32 n, int32 X, int32 dX, int32 Y, int32 dY);
+
 	#define DRAW_PIXEL(N, M) PIXEL::Draw(N, M, Offset, OffsetInLine, Pix, OP::Z1(D, b), OP::Z2(D, b))
 
 	struct DrawMode7BG1_OP
@@ -536,8 +564,6 @@ namespace TileImpl {
 
 		static void Draw(uint32 Left, uint32 Right, int D)
 		{
-			uint8	*VRAM1 = Memory.VRAM + 1;
-
 			if (OP::DCMODE())
 			{
 				GFX.RealScreenColors = DirectColourMaps[0];
@@ -549,6 +575,7 @@ namespace TileImpl {
 
 			int	aa, cc;
 			int	startx;
+			uint8	Texels[SNES_WIDTH];
 
 			uint32	Offset = GFX.StartY * GFX.PPL;
 			struct SLineMatrixData	*l = &LineMatrixData[GFX.StartY];
@@ -593,41 +620,13 @@ namespace TileImpl {
 
 				uint8	Pix;
 
-				if (!PPU.Mode7Repeat)
-				{
-					for (uint32 x = Left; x < Right; x++, AA += aa, CC += cc)
-					{
-						int	X = ((AA + BB) >> 8) & 0x3ff;
-						int	Y = ((CC + DD) >> 8) & 0x3ff;
-
-						uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);
-						uint8	b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1));
+				Mode7Texels(Texels, Right - Left, AA + BB, aa, CC + DD, cc);
 
-						Pix = b & OP::MASK; DRAW_PIXEL(x, Pix);
-					}
-				}
-				else
+				for (uint32 x = Left; x < Right; x++)
 				{
-					for (uint32 x = Left; x < Right; x++, AA += aa, CC += cc)
-					{
-						int	X = ((AA + BB) >> 8);
-						int	Y = ((CC + DD) >> 8);
-
-						uint8	b;
-
-						if (((X | Y) & ~0x3ff) == 0)
-						{
-							uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);
-							b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1));
-						}
-						else
-						if (PPU.Mode7Repeat == 3)
-							b = *(VRAM1    + ((Y & 7) << 4) + ((X & 7) << 1));
-						else
-							continue;
+					uint8	b = Texels[x - Left];
 
-						Pix = b & OP::MASK; DRAW_PIXEL(x, Pix);
-					}
+					Pix = b & OP::MASK; DRAW_PIXEL(x, Pix);
 				}
 			}
 		}
@@ -51,6 +51,7 @@
 #include "snes9x/memmap.h"
 #include "snes9x/apu/apu.h"
 #include "snes9x/controls.h"
+#include "snes9x/runahead.h"
 
 int ScreenshotRequested = 0;
 int ConfigRequested = 0;
@@ -553,6 +554,10 @@ int main(int argc, char *argv[])
 		Settings.JustifierMaster = (GCSettings.Controller == CTRL_JUST ? true : false);
 		SetControllers();
 
+		// sized for the loaded game, so set up every time emulation resumes
+		if (!S9xRunAheadInit(GCSettings.RunAhead))
+			GCSettings.RunAhead = 0;
+
 		// stop checking if devices were removed/inserted
 		// since we're starting emulation again
 		HaltDeviceThread();
@@ -567,7 +572,7 @@ int main(int argc, char *argv[])
 
 		while(1) // emulation loop
 		{
-			S9xMainLoop();
+			S9xRunAheadFrame();
 			ReportButtons();
 
 			if (ResetRequested)
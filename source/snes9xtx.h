@@ -136,6 +136,7 @@ struct SGCSettings{
 	int		HiResMode;
 	int		FrameSkip;
 	int		ShowFrameRate;
+	int		RunAhead;	// frames to run ahead, 0 - Off
 	int		crosshair;
 	int		aspect;
 	int		xshift;		// Video output shift
@@ -31,6 +31,7 @@
 
 #include "snes9x/snes9x.h"
 #include "snes9x/memmap.h"
+#include "snes9x/gfx.h"
 
 extern void UpdatePlaybackRate(void);
 
@@ -726,6 +727,26 @@ MakeTexture (const void *src, void *dst, s32 width, s32 height)
 	);
 }
 
+/****************************************************************************
+ * UpdatePresentTarget
+ *
+ * Unless a filter needs the frame first, the core writes each band of lines
+ * straight into texturemem in the GX tile layout as soon as it is drawn
+ * (S9xPresentTiled4x4), so there is no MakeTexture pass over the frame.
+ ***************************************************************************/
+static void
+UpdatePresentTarget ()
+{
+#ifdef HW_RVL
+	if (GCSettings.VideoFilter != FILTER_NONE)
+	{
+		S9xSetPresentTarget (PRESENT_NONE, NULL);
+		return;
+	}
+#endif
+	S9xSetPresentTarget (PRESENT_TILED4X4, (uint16 *) texturemem);
+}
+
 /****************************************************************************
  * Update Video
  ***************************************************************************/
@@ -827,9 +848,11 @@ update_video (int width, int height)
 	}
 	else
 #endif
+	if (!GFX.PresentLines)
 	{
 		MakeTexture((char *) GFX.Screen, (char *) texturemem, vwidth, vheight);
 	}
+	// else the core already wrote the frame into texturemem as it drew it
 
 	DCFlushRange (texturemem, TEXTUREMEM_SIZE);	// update the texture memory
 	GX_InvalidateTexAll ();
@@ -863,6 +886,9 @@ update_video (int width, int height)
 	VIDEO_Flush ();
 	copynow = GX_TRUE;
 
+	// GX is done with the texture, so the next frame can be drawn into it
+	UpdatePresentTarget ();
+
 	// Return to caller, don't waste time waiting for vb
 	LWP_ResumeThread (vbthread);
 }